@@ -0,0 +1,95 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+/*
+    Simulation benchmark, built and run on Linux by "make bench"
+    Host timings only compare builds of the simulation with each other : the GBA cost
+    is given by the profiler (PROFILER_ENABLED) and the fish kernel stats.
+*/
+
+#include <chrono>
+#include <cstdio>
+
+#include "game_sim.h"
+#include "collision_items_lvl0.h"
+
+#define BENCH_FRAMES 1000000
+
+using bench_clock = std::chrono::steady_clock;
+
+static volatile int bench_sink;
+
+static void report(const char* name, int iterations, bench_clock::time_point start) {
+    double seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    std::printf("%-24s %10d iterations %8.3f s %12.0f /s %9.1f ns each\n",
+                name, iterations, seconds, iterations / seconds, seconds * 1e9 / iterations);
+}
+
+// Whole game frames, the player swims around and eats with a scripted input
+static void bench_game() {
+    bn::random random;
+    bn::random input_random;
+    GameSim<FISH_MAX_NUMBER> sim(random, 512, 512, collision_items::lvl0);
+    // A crowded level, as in a long game
+    for(int index = sim.fish.size(); index < FISH_MAX_NUMBER; index++) {
+        createFish(sim.fish, sim.fish_context, FISH_TYPE_DEFORMATION);
+    }
+    sim.fish_number = FISH_MAX_NUMBER;
+
+    unsigned input = 0;
+    auto start = bench_clock::now();
+    for(int frame = 0; frame < BENCH_FRAMES; frame++) {
+        if(frame % 30 == 0) input = input_random.get_int(PJ_INPUT_EAT << 1);
+        sim.step(input, sim.player.x(), sim.player.y());
+        sim.player.takeEvents();
+        input &= ~PJ_INPUT_EAT;
+        if(sim.over()) sim.player.setFullLife();
+    }
+    report("game step (64 fish)", BENCH_FRAMES, start);
+    bench_sink = sim.fish_points;
+}
+
+// Fish only, without threat
+static void bench_fish() {
+    bn::random random;
+    FishContext context = create_fish_context(random, 512, 512, collision_items::lvl0);
+    FishSim<FISH_MAX_NUMBER> fish(context);
+    for(int index = 0; index < FISH_MAX_NUMBER; index++) {
+        createFish(fish, context, FISH_TYPE_DEFORMATION);
+    }
+
+    auto start = bench_clock::now();
+    for(int frame = 0; frame < BENCH_FRAMES; frame++) {
+        fish.update(0, 0);
+    }
+    report("fish update (64 fish)", BENCH_FRAMES, start);
+    bench_sink = fish.getX(0).data();
+}
+
+// Swept collision of the piranha hitbox on the whole level
+static void bench_collision() {
+    const CollisionGrid& grid = collision_items::lvl0;
+    bn::random random;
+    int contacts = 0;
+
+    auto start = bench_clock::now();
+    for(int iteration = 0; iteration < BENCH_FRAMES; iteration++) {
+        bn::fixed x = random.get_int(-240, 240);
+        bn::fixed y = random.get_int(-240, 240);
+        bn::fixed dx = random.get_fixed(-3, 3);
+        bn::fixed dy = random.get_fixed(-3, 3);
+        CollisionContact contact = sweep_box(x, y, dx, dy, PJ_HITBOX_HALF_SIZE, grid);
+        contacts += contact.normal_x != 0 || contact.normal_y != 0;
+    }
+    report("sweep_box", BENCH_FRAMES, start);
+    bench_sink = contacts;
+}
+
+int main() {
+    bench_game();
+    bench_fish();
+    bench_collision();
+    return(0);
+}
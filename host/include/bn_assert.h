@@ -0,0 +1,14 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BN_ASSERT_H
+#define BN_ASSERT_H
+
+#include <cassert>
+
+// Host stand-in of butano's bn_assert.h, the message is dropped
+#define BN_ASSERT(condition, ...) assert(condition)
+
+#endif
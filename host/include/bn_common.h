@@ -0,0 +1,15 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BN_COMMON_H
+#define BN_COMMON_H
+
+/*
+    Host stand-in of butano's bn_common.h : no IWRAM / EWRAM on Linux
+*/
+#define BN_CODE_IWRAM
+#define BN_DATA_EWRAM
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BN_FIXED_H
+#define BN_FIXED_H
+
+#include <concepts>
+#include <cstdint>
+
+/*
+    Host stand-in of butano's bn::fixed_t : same 32 bits storage, same rounding
+    (multiplication and division through 64 bits, integer() truncates toward zero),
+    so the simulation gives the same results as on the GBA.
+*/
+namespace bn
+{
+    template<int Precision>
+    class fixed_t {
+        private:
+            int _data = 0;
+
+        public:
+            static constexpr int scale() {
+                return(1 << Precision);
+            }
+            static constexpr fixed_t from_data(int data) {
+                fixed_t result;
+                result._data = data;
+                return(result);
+            }
+
+            constexpr fixed_t() = default;
+            constexpr fixed_t(int value) :
+                _data(value << Precision) {
+            }
+            template<std::floating_point Float>
+            constexpr fixed_t(Float value) :
+                _data(int(value * scale())) {
+            }
+
+            constexpr int data() const {
+                return(this->_data);
+            }
+            constexpr int integer() const {
+                return(this->_data / scale());
+            }
+            constexpr int round_integer() const {
+                return((this->_data + scale() / 2) >> Precision);
+            }
+            constexpr fixed_t multiplication(fixed_t other) const {
+                return(from_data(int((int64_t(this->_data) * other._data) >> Precision)));
+            }
+            constexpr fixed_t division(fixed_t other) const {
+                return(from_data(int((int64_t(this->_data) << Precision) / other._data)));
+            }
+
+            constexpr fixed_t operator-() const {
+                return(from_data(-this->_data));
+            }
+            constexpr fixed_t& operator+=(fixed_t other) {
+                this->_data += other._data;
+                return(*this);
+            }
+            constexpr fixed_t& operator-=(fixed_t other) {
+                this->_data -= other._data;
+                return(*this);
+            }
+            constexpr fixed_t& operator*=(fixed_t other) {
+                *this = this->multiplication(other);
+                return(*this);
+            }
+            template<std::integral Int>
+            constexpr fixed_t& operator*=(Int value) {
+                this->_data *= value;
+                return(*this);
+            }
+            constexpr fixed_t& operator/=(fixed_t other) {
+                *this = this->division(other);
+                return(*this);
+            }
+            template<std::integral Int>
+            constexpr fixed_t& operator/=(Int value) {
+                this->_data /= value;
+                return(*this);
+            }
+
+            friend constexpr fixed_t operator+(fixed_t a, fixed_t b) {
+                return(from_data(a._data + b._data));
+            }
+            friend constexpr fixed_t operator-(fixed_t a, fixed_t b) {
+                return(from_data(a._data - b._data));
+            }
+            friend constexpr fixed_t operator*(fixed_t a, fixed_t b) {
+                return(a.multiplication(b));
+            }
+            template<std::integral Int>
+            friend constexpr fixed_t operator*(fixed_t a, Int b) {
+                return(from_data(a._data * b));
+            }
+            template<std::integral Int>
+            friend constexpr fixed_t operator*(Int a, fixed_t b) {
+                return(from_data(a * b._data));
+            }
+            friend constexpr fixed_t operator/(fixed_t a, fixed_t b) {
+                return(a.division(b));
+            }
+            template<std::integral Int>
+            friend constexpr fixed_t operator/(fixed_t a, Int b) {
+                return(from_data(a._data / b));
+            }
+            friend constexpr bool operator==(fixed_t a, fixed_t b) {
+                return(a._data == b._data);
+            }
+            friend constexpr bool operator<(fixed_t a, fixed_t b) {
+                return(a._data < b._data);
+            }
+            friend constexpr bool operator>(fixed_t a, fixed_t b) {
+                return(a._data > b._data);
+            }
+            friend constexpr bool operator<=(fixed_t a, fixed_t b) {
+                return(a._data <= b._data);
+            }
+            friend constexpr bool operator>=(fixed_t a, fixed_t b) {
+                return(a._data >= b._data);
+            }
+    };
+
+    using fixed = fixed_t<12>;
+}
+
+#endif
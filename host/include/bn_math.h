@@ -0,0 +1,20 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BN_MATH_H
+#define BN_MATH_H
+
+#include "bn_fixed.h"
+
+namespace bn
+{
+    // Host stand-in of butano's bn::abs
+    template<typename Type>
+    constexpr Type abs(Type value) {
+        return(value >= 0 ? value : -value);
+    }
+}
+
+#endif
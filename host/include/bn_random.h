@@ -0,0 +1,60 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BN_RANDOM_H
+#define BN_RANDOM_H
+
+#include "bn_fixed.h"
+
+namespace bn
+{
+    /*
+        Host stand-in of butano's bn::random : xorshift32 with the same default seed
+    */
+    class random {
+        private:
+            unsigned _seed = 123456789;
+
+        public:
+            constexpr random() = default;
+
+            constexpr unsigned seed() const {
+                return(this->_seed);
+            }
+            constexpr void set_seed(unsigned seed) {
+                this->_seed = seed;
+            }
+            constexpr unsigned get() {
+                this->update();
+                return(this->_seed);
+            }
+            constexpr void update() {
+                this->_seed ^= this->_seed << 13;
+                this->_seed ^= this->_seed >> 17;
+                this->_seed ^= this->_seed << 5;
+            }
+            constexpr bool get_bool() {
+                return(this->get() & 1);
+            }
+            // [0, limit)
+            constexpr int get_int(int limit) {
+                return(int(this->get() % unsigned(limit)));
+            }
+            // [minimum, maximum)
+            constexpr int get_int(int minimum, int maximum) {
+                return(minimum + this->get_int(maximum - minimum));
+            }
+            // [0, limit)
+            constexpr fixed get_fixed(fixed limit) {
+                return(fixed::from_data(this->get_int(limit.data())));
+            }
+            // [minimum, maximum)
+            constexpr fixed get_fixed(fixed minimum, fixed maximum) {
+                return(fixed::from_data(this->get_int(minimum.data(), maximum.data())));
+            }
+    };
+}
+
+#endif
@@ -0,0 +1,551 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+/*
+    Unit tests of the game simulation, built and run on Linux by "make test"
+*/
+
+#include <cstdio>
+#include "bn_math.h"
+
+#include "game_sim.h"
+#include "input_log.h"
+#include "collision_items_lvl0.h"
+
+static int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            failures += 1; \
+        } \
+    } while(false)
+
+/*
+    8x8 cells (64x64 pixels) test level centered on (0, 0), like the level backgrounds :
+    cell (column, row) covers x in [column*8 - 32, column*8 - 24).
+*/
+#define TEST_GRID_SIZE 8
+
+struct TestLevel {
+    unsigned char cells[TEST_GRID_SIZE * TEST_GRID_SIZE / 2] = {};
+
+    void set(int column, int row, unsigned char flags) {
+        unsigned char& pair = this->cells[(row * TEST_GRID_SIZE + column) >> 1];
+        if(column & 1) pair = (pair & 0x0F) | (flags << 4);
+        else pair = (pair & 0xF0) | flags;
+    }
+    CollisionGrid grid() const {
+        return(CollisionGrid(this->cells, TEST_GRID_SIZE, TEST_GRID_SIZE));
+    }
+};
+
+// Wall on the whole column 6 (x in [16, 24))
+static TestLevel wall_level() {
+    TestLevel level;
+    for(int row = 0; row < TEST_GRID_SIZE; row++) level.set(6, row, TILE_FLAG_SOLID);
+    return(level);
+}
+
+// bn::random from the default seed : butano's xorshift32 (13, 17, 5) sequence
+static void test_random_sequence() {
+    bn::random random;
+    CHECK(random.seed() == 123456789u);
+    CHECK(random.get() == 2714967881u);
+    CHECK(random.get() == 2238813396u);
+    CHECK(random.get() == 1250077441u);
+    CHECK(random.get() == 3820100336u);
+    random.set_seed(123456789);
+    CHECK(random.get_int(100) == 81);
+    CHECK(random.get_int(-50, 50) == 46);
+    CHECK(random.get_bool());
+}
+
+// bn::fixed rounding : 64 bits multiplication and division, integer() truncates toward zero
+static void test_fixed_arithmetic() {
+    CHECK(bn::fixed(-0.1).data() == -409);
+    CHECK((bn::fixed(1.5) * bn::fixed(-2.25)).data() == -13824);
+    CHECK((bn::fixed(-0.1) * 3).data() == -1227);
+    CHECK((bn::fixed(-0.1) * bn::fixed(3)).data() == -1227);
+    CHECK((bn::fixed::from_data(-409) * bn::fixed(0.5)).data() == -205);
+    CHECK((bn::fixed(7) / bn::fixed(2)).data() == 14336);
+    CHECK((bn::fixed(1) / bn::fixed(3)).data() == 1365);
+    CHECK((bn::fixed(-1) / bn::fixed(3)).data() == -1365);
+    CHECK((bn::fixed(300) * bn::fixed(300)).integer() == 90000);
+    CHECK(bn::fixed(-1.5).integer() == -1);
+    CHECK(bn::fixed::from_data(-1).integer() == 0);
+    CHECK(bn::fixed(2.75).integer() == 2);
+}
+
+static void test_tile_flags() {
+    TestLevel level = wall_level();
+    level.set(2, 5, TILE_FLAG_SPIKE | TILE_PUSH_UP);
+    CollisionGrid grid = level.grid();
+    CHECK(tile_flags_at(17, -7, grid) == TILE_FLAG_SOLID);
+    CHECK(tile_flags_at(15, -7, grid) == 0);
+    CHECK(tile_flags_at(-12, 9, grid) == (TILE_FLAG_SPIKE | TILE_PUSH_UP));
+    // Outside of the level
+    CHECK(tile_flags_at(100, 0, grid) == 0);
+    CHECK(tile_flags_at(0, -100, grid) == 0);
+}
+
+static void test_sweep_box() {
+    TestLevel level = wall_level();
+    CollisionGrid grid = level.grid();
+
+    // The right edge of the box stays out of the wall
+    CollisionContact contact = sweep_box(8, 0, 2, 0, PJ_HITBOX_HALF_SIZE, grid);
+    CHECK(contact.normal_x == 0 && contact.normal_y == 0);
+
+    // The right edge enters the wall : pushed back to the left
+    contact = sweep_box(8, 0, 6, 0, PJ_HITBOX_HALF_SIZE, grid);
+    CHECK(contact.normal_x == -1);
+    CHECK(contact.normal_y == 0);
+
+    // Fast enough to jump over the wall in one frame, still stopped
+    contact = sweep_box(-16, 0, 48, 0, PJ_HITBOX_HALF_SIZE, grid);
+    CHECK(contact.normal_x == -1);
+
+    // Moving away from the wall
+    contact = sweep_box(8, 0, -6, 0, PJ_HITBOX_HALF_SIZE, grid);
+    CHECK(contact.normal_x == 0);
+}
+
+static void test_sweep_box_lvl0() {
+    const CollisionGrid& grid = collision_items::lvl0;
+    CHECK(grid.columns() == 64 && grid.rows() == 64);
+
+    // Open water at the start position
+    CollisionContact contact = sweep_box(0, 0, 2, 2, PJ_HITBOX_HALF_SIZE, grid);
+    CHECK(contact.normal_x == 0 && contact.normal_y == 0 && contact.spike_flags == 0);
+
+    // Swimming straight left from the start hits the level border
+    bool hit = false;
+    for(int x = 0; x > -4 * grid.columns() && !hit; x -= 2) {
+        hit = sweep_box(x, 0, -2, 0, PJ_HITBOX_HALF_SIZE, grid).normal_x == 1;
+    }
+    CHECK(hit);
+}
+
+static void test_player_bounce() {
+    TestLevel level = wall_level();
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    PlayerCore player(8, 0, grid, random);
+    player.takeEvents();
+
+    unsigned events = 0;
+    for(int frame = 0; frame < 120; frame++) {
+        player.update(PJ_INPUT_RIGHT);
+        events |= player.takeEvents();
+        // The hitbox covers the pixels [x - 4, x + 4)
+        CHECK(player.x().integer() + PJ_HITBOX_HALF_SIZE <= 16);
+    }
+    CHECK(events & PJ_EVENT_BOUNCE);
+    CHECK(!(events & PJ_EVENT_CHOC));
+    CHECK(!player.facingLeft());
+
+    events = 0;
+    for(int frame = 0; frame < 30; frame++) {
+        player.update(PJ_INPUT_LEFT);
+        events |= player.takeEvents();
+    }
+    CHECK(player.getSpeedX() < 0);
+    CHECK(player.facingLeft());
+    CHECK(events & PJ_EVENT_FLIP);
+}
+
+static void test_player_choc() {
+    TestLevel level = wall_level();
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    PlayerCore player(8, 0, grid, random);
+    player.setStateEat();
+    player.takeEvents();
+
+    bn::fixed maxspeed = bn::fixed(0.03) * 80;
+    bool choc = false;
+    for(int frame = 0; frame < 60 && !choc; frame++) {
+        bn::fixed speed = player.getSpeedX();
+        player.update(PJ_INPUT_RIGHT);
+        if(player.takeEvents() & PJ_EVENT_CHOC) {
+            choc = true;
+            // The reciprocal gives abs(speed / maxspeed), less than a unit away
+            bn::fixed expected = bn::abs(speed / maxspeed) > 1 ? bn::fixed(1) : bn::abs(speed / maxspeed);
+            CHECK(player.impact() > 0 && player.impact() <= 1);
+            CHECK(bn::abs(player.impact().data() - expected.data()) <= 1);
+        }
+    }
+    CHECK(choc);
+}
+
+static void test_player_spike() {
+    TestLevel level;
+    level.set(4, 4, TILE_FLAG_SPIKE | TILE_PUSH_UP);
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    PlayerCore player(4, 4, grid, random);
+    player.takeEvents();
+
+    player.update(0);
+    CHECK(player.takeEvents() & PJ_EVENT_HURT);
+    CHECK(player.getSpeedY() < 0);
+    CHECK(player.getLife() == PJ_LIFE_MAX - 1);
+
+    // Invincible while hurt
+    player.hurt();
+    CHECK(player.getLife() == PJ_LIFE_MAX - 1);
+}
+
+static void test_player_wall_push() {
+    // Accelerating into the wall, then pushed into it by a spike
+    TestLevel levels[2] = {wall_level(), wall_level()};
+    levels[1].set(5, 4, TILE_FLAG_SPIKE | TILE_PUSH_RIGHT);
+
+    for(const TestLevel& level : levels) {
+        CollisionGrid grid = level.grid();
+        for(int start = 0; start < 16; start++) {
+            bn::random random;
+            PlayerCore player(bn::fixed(start) / 4, 4, grid, random);
+            for(int frame = 0; frame < 120; frame++) {
+                player.update(PJ_INPUT_RIGHT);
+                // The right edge of the hitbox stays out of the solid cell
+                CHECK(!(tile_flags_at(player.x() + PJ_HITBOX_HALF_SIZE - 1, player.y(), grid) & TILE_FLAG_SOLID));
+            }
+        }
+    }
+}
+
+static void test_player_life() {
+    TestLevel level;
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    PlayerCore player(0, 0, grid, random);
+
+    // 0.2 life per second, rounded
+    for(int frame = 0; frame < PJ_LIFE_DRAIN_FRAMES / 2; frame++) player.update(0);
+    CHECK(player.getLife() == PJ_LIFE_MAX);
+    player.update(0);
+    CHECK(player.getLife() == PJ_LIFE_MAX - 1);
+    player.heal(1);
+    CHECK(player.getLife() == PJ_LIFE_MAX);
+
+    int frames = 0;
+    while(player.getLife() > 0 && frames < 10000) {
+        player.update(0);
+        frames += 1;
+    }
+    // About 0.2 life per second
+    CHECK(frames > 2000 && frames < 2600);
+    CHECK(player.x() == 0 && player.y() == 0);
+}
+
+static void test_fish_direction() {
+    CHECK(fish_direction_from(0, 0) == DIRECTION_NONE);
+    CHECK(fish_direction_from(10, 1) == DIRECTION_RIGHT);
+    CHECK(fish_direction_from(-10, -1) == DIRECTION_LEFT);
+    CHECK(fish_direction_from(1, -10) == DIRECTION_UP);
+    CHECK(fish_direction_from(0, 3) == DIRECTION_DOWN);
+    CHECK(fish_direction_from(5, 5) == DIRECTION_DOWN_RIGHT);
+    CHECK(fish_direction_from(-5, -4) == DIRECTION_UP_LEFT);
+    for(int direction = 0; direction < DIRECTION_NONE; direction++) {
+        CHECK(fish_reflect_x[fish_reflect_x[direction]] == direction);
+        CHECK(fish_reflect_y[fish_reflect_y[direction]] == direction);
+        CHECK(fish_direction_x[fish_reflect_x[direction]] == -fish_direction_x[direction]);
+        CHECK(fish_direction_y[fish_reflect_y[direction]] == -fish_direction_y[direction]);
+    }
+}
+
+static void test_spatial_grid() {
+    SpatialGrid<8, 16> grid(128, 128);
+    grid.insert(0, -50, -50);
+    grid.insert(1, 40, 40);
+    grid.insert(2, 45, 35);
+
+    int found = 0;
+    grid.query(40, 40, 8, [&](int index) {
+        found |= 1 << index;
+        return(true);
+    });
+    CHECK(found == 0x06);
+
+    grid.move(2, -45, -45);
+    found = 0;
+    grid.query(-48, -48, 8, [&](int index) {
+        found |= 1 << index;
+        return(true);
+    });
+    CHECK(found == 0x05);
+
+    grid.remove(0);
+    found = 0;
+    grid.query(-48, -48, 8, [&](int index) {
+        found |= 1 << index;
+        return(true);
+    });
+    CHECK(found == 0x04);
+}
+
+static void test_fish_bounds() {
+    const CollisionGrid& grid = collision_items::lvl0;
+    int width = grid.columns() * 8;
+    int height = grid.rows() * 8;
+    bn::random random;
+    FishContext context = create_fish_context(random, width, height, grid);
+    FishSim<FISH_MAX_NUMBER> fish(context);
+    for(int index = 0; index < FISH_MAX_NUMBER; index++) {
+        createFish(fish, context, FISH_TYPE_DEFORMATION);
+    }
+    CHECK(fish.size() == FISH_MAX_NUMBER);
+    CHECK(createFish(fish, context, FISH_TYPE_NORMAL) == -1);
+
+    fish.setThreat(0, 0);
+    bool inside = true;
+    for(int frame = 0; frame < 3000; frame++) {
+        fish.update(0, 0);
+        for(int index = 0; index < fish.capacity(); index++) {
+            // Spawned anywhere in the level, a culled fish can overshoot the border by one move
+            if(fish.getX(index) < -width/2 - 12 || fish.getX(index) > width/2 + 12 ||
+               fish.getY(index) < -height/2 - 12 || fish.getY(index) > height/2 + 12) {
+                inside = false;
+            }
+        }
+    }
+    CHECK(inside);
+    for(int index = 0; index < fish.capacity(); index++) {
+        CHECK(fish.getState(index) == FISH_STATE_NORMAL);
+        // Culling : only fish around the view are visible
+        if(fish.isVisible(index)) {
+            CHECK(fish.getX(index) > -(GBA_SCREEN_WIDTH/2 + FISH_VIEW_MARGIN + FISH_VIEW_HYSTERESIS));
+            CHECK(fish.getX(index) < GBA_SCREEN_WIDTH/2 + FISH_VIEW_MARGIN + FISH_VIEW_HYSTERESIS);
+        }
+    }
+}
+
+// Only the fish of the flee list swim away, also after a release in the middle of the list
+static void test_fish_behaviors() {
+    TestLevel level;
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    FishContext context = create_fish_context(random, 512, 512, grid);
+    FishSim<8> fish(context);
+    int fleeing[3];
+    for(int& index : fleeing) {
+        index = fish.spawn(FISH_TYPE_SPEED, 20, 0, 0, 1000, 0);
+    }
+    fish.release(fleeing[1]);
+    // Takes the released slot
+    int calm = fish.spawn(FISH_TYPE_DEFORMATION, 20, 0, 0, 1000, 0);
+    CHECK(calm == fleeing[1]);
+    unsigned char calm_direction = fish.getDirection(calm);
+
+    fish.setThreat(0, 0);
+    for(int frame = 0; frame < 32; frame++) {
+        fish.update(0, 0);
+    }
+    CHECK(fish.getDirection(fleeing[0]) == DIRECTION_RIGHT);
+    CHECK(fish.getDirection(fleeing[2]) == DIRECTION_RIGHT);
+    CHECK(fish.getDirection(calm) == calm_direction);
+}
+
+// Out of view but around the threat : moved every frame, never from a stale position
+static void test_fish_awake() {
+    TestLevel level;
+    CollisionGrid grid = level.grid();
+    bn::random random;
+    FishContext context = create_fish_context(random, 512, 512, grid);
+    FishSim<8> fish(context);
+    int near = fish.spawn(FISH_TYPE_DEFORMATION, 100, 0, 1, 1000, 0);
+    int far = fish.spawn(FISH_TYPE_DEFORMATION, 100 + 2 * FISH_AWAKE_RADIUS, 0, 1, 1000, 0);
+
+    // The view is far away, the threat is next to the first fish
+    fish.setThreat(100, 10);
+    for(int frame = 0; frame < 32; frame++) {
+        fish.update(-1000, -1000);
+    }
+    int near_moves = 0;
+    int far_moves = 0;
+    for(int frame = 0; frame < 8; frame++) {
+        bn::fixed near_x = fish.getX(near);
+        bn::fixed near_y = fish.getY(near);
+        bn::fixed far_x = fish.getX(far);
+        bn::fixed far_y = fish.getY(far);
+        fish.update(-1000, -1000);
+        near_moves += fish.getX(near) != near_x || fish.getY(near) != near_y;
+        far_moves += fish.getX(far) != far_x || fish.getY(far) != far_y;
+    }
+    CHECK(!fish.isVisible(near) && !fish.isVisible(far));
+    CHECK(near_moves == 8);
+    CHECK(far_moves == 8 / FISH_CULLED_PERIOD);
+}
+
+static void test_game_eat() {
+    bn::random random;
+    GameSim<FISH_MAX_NUMBER> sim(random, 512, 512, collision_items::lvl0);
+    CHECK(sim.fish.size() == FISH_START_NUMBER);
+
+    // A fish that does not swim, right in front of the piranha
+    int index = sim.fish.spawn(FISH_TYPE_SPEED, 0, 0, 0, 100, 0);
+    for(int frame = 0; frame < 31; frame++) {
+        sim.step(0, 0, 0);
+    }
+    CHECK(sim.fish.getState(index) == FISH_STATE_NORMAL);
+    sim.player.takeEvents();
+
+    sim.step(PJ_INPUT_EAT, 0, 0);
+    CHECK(sim.player.getState() == PJ_STATE_EATING);
+    sim.step(0, 0, 0);
+    CHECK(sim.fish_points == 1);
+    CHECK(sim.fish.getState(index) == FISH_STATE_DYING);
+    CHECK(sim.player.getFX() == PJ_FX_SPEED);
+    unsigned events = sim.player.takeEvents();
+    CHECK(events & PJ_EVENT_EAT);
+    CHECK(events & PJ_EVENT_GRUNT);
+
+    // The dead fish is replaced by a new one
+    for(int frame = 0; frame < 30; frame++) {
+        sim.step(0, 0, 0);
+    }
+    CHECK(sim.fish.size() == FISH_START_NUMBER + 1);
+}
+
+// One more fish every 5 points, up to the game limit whatever the pool capacity
+static void test_game_fish_number() {
+    bn::random random;
+    GameSim<FISH_MAX_NUMBER> sim(random, 512, 512, collision_items::lvl0);
+
+    for(int points = 5; points <= 5 * FISH_MAX_NUMBER; points += 5) {
+        sim.fish_points = points;
+        for(int index = 0; index < sim.fish.capacity(); index++) {
+            if(sim.fish.active(index) && sim.fish.getState(index) == FISH_STATE_NORMAL) {
+                sim.fish.kill(index);
+                break;
+            }
+        }
+        for(int frame = 0; frame < 40; frame++) {
+            sim.step(0, 0, 0);
+        }
+    }
+    CHECK(sim.fish_number == FISH_GAME_MAX_NUMBER);
+    CHECK(sim.fish.size() == FISH_GAME_MAX_NUMBER);
+}
+
+// Same seed and same input : same game
+static void test_game_determinism() {
+    bn::random random_a;
+    bn::random random_b;
+    GameSim<FISH_MAX_NUMBER> sim_a(random_a, 512, 512, collision_items::lvl0);
+    GameSim<FISH_MAX_NUMBER> sim_b(random_b, 512, 512, collision_items::lvl0);
+    bn::random input_random;
+
+    unsigned input = 0;
+    bool same = true;
+    for(int frame = 0; frame < 2000 && !sim_a.over(); frame++) {
+        if(frame % 20 == 0) input = input_random.get_int(PJ_INPUT_EAT << 1);
+        sim_a.step(input, sim_a.player.x(), sim_a.player.y());
+        sim_b.step(input, sim_b.player.x(), sim_b.player.y());
+        input &= ~PJ_INPUT_EAT;
+
+        same = same && sim_a.player.x() == sim_b.player.x() && sim_a.player.y() == sim_b.player.y() &&
+               sim_a.fish_points == sim_b.fish_points && sim_a.player.takeEvents() == sim_b.player.takeEvents();
+        for(int index = 0; index < sim_a.fish.capacity() && same; index++) {
+            same = sim_a.fish.getState(index) == sim_b.fish.getState(index) &&
+                   (!sim_a.fish.active(index) || (sim_a.fish.getX(index) == sim_b.fish.getX(index) &&
+                                                  sim_a.fish.getY(index) == sim_b.fish.getY(index)));
+        }
+    }
+    CHECK(same);
+}
+
+static void test_input_log() {
+    InputRun buffer[4];
+    InputLog log(buffer, 4);
+    for(int frame = 0; frame < 300; frame++) log.record(PJ_INPUT_LEFT);
+    CHECK(log.record(PJ_INPUT_LEFT | PJ_INPUT_EAT));
+    CHECK(log.record(0));
+    // 300 frames : two runs
+    CHECK(log.size() == 4);
+    CHECK(!log.record(PJ_INPUT_UP));
+    CHECK(log.record(0));
+
+    int frames = 0;
+    int eat_frame = -1;
+    while(!log.finished()) {
+        unsigned input = log.play();
+        if(input & PJ_INPUT_EAT) eat_frame = frames;
+        frames += 1;
+    }
+    CHECK(frames == 303);
+    CHECK(eat_frame == 300);
+    CHECK(log.play() == 0);
+
+    log.rewind();
+    CHECK(log.play() == PJ_INPUT_LEFT);
+}
+
+// A game replayed from its seed and its input log is the same game
+static void test_input_replay() {
+    InputRun buffer[4096];
+    InputLog log(buffer, 4096);
+    bn::random input_random;
+    unsigned seed = 987654321;
+
+    bn::random random_a;
+    random_a.set_seed(seed);
+    GameSim<FISH_MAX_NUMBER> sim_a(random_a, 512, 512, collision_items::lvl0);
+    unsigned input = 0;
+    int frames = 0;
+    while(!sim_a.over()) {
+        if(frames % 15 == 0) input = input_random.get_int(PJ_INPUT_EAT << 1);
+        CHECK(log.record(input));
+        sim_a.step(input, sim_a.player.x(), sim_a.player.y());
+        input &= ~PJ_INPUT_EAT;
+        frames += 1;
+    }
+
+    bn::random random_b;
+    random_b.set_seed(seed);
+    GameSim<FISH_MAX_NUMBER> sim_b(random_b, 512, 512, collision_items::lvl0);
+    int replay_frames = 0;
+    while(!sim_b.over() && !log.finished()) {
+        sim_b.step(log.play(), sim_b.player.x(), sim_b.player.y());
+        replay_frames += 1;
+    }
+    CHECK(replay_frames == frames);
+    CHECK(sim_b.over());
+    CHECK(sim_b.fish_points == sim_a.fish_points);
+    CHECK(sim_b.player.x() == sim_a.player.x() && sim_b.player.y() == sim_a.player.y());
+}
+
+int main() {
+    test_random_sequence();
+    test_fixed_arithmetic();
+    test_tile_flags();
+    test_sweep_box();
+    test_sweep_box_lvl0();
+    test_player_bounce();
+    test_player_choc();
+    test_player_spike();
+    test_player_wall_push();
+    test_player_life();
+    test_fish_direction();
+    test_spatial_grid();
+    test_fish_bounds();
+    test_fish_behaviors();
+    test_fish_awake();
+    test_game_eat();
+    test_game_fish_number();
+    test_game_determinism();
+    test_input_log();
+    test_input_replay();
+
+    if(failures) {
+        std::printf("%d check(s) failed\n", failures);
+        return(1);
+    }
+    std::printf("All tests passed\n");
+    return(0);
+}
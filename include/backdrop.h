@@ -0,0 +1,85 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BACKDROP_H
+#define BACKDROP_H
+
+#include "bn_math.h"
+#include "bn_span.h"
+#include "bn_optional.h"
+#include "bn_rect_window.h"
+#include "bn_affine_bg_ptr.h"
+#include "bn_affine_bg_mat_attributes.h"
+#include "bn_affine_bg_mat_attributes_hbe_ptr.h"
+
+#include "world.h"
+
+/*
+    Wobble of the affine background, precomputed for a whole cycle.
+    Line i at frame f is rotated by sin(Phase*f + Frequency*(i+1)) * Amplitude degrees.
+    The angle only depends on (i + shift*f/slices), so each of the <slices> tables is
+    a strip of lines and a frame only has to point the HBE to the right slice of it.
+*/
+template<int Frequency, int Phase, int Amplitude>
+class Wobble {
+    private:
+        static constexpr int gcd(int a, int b) {
+            return b == 0 ? a : gcd(b, a % b);
+        }
+    public:
+        static constexpr int LINE_PERIOD = 360 / gcd(Frequency, 360);
+        static constexpr int SLICES = Frequency / gcd(Frequency, Phase);
+        static constexpr int LINE_SHIFT = Phase / gcd(Frequency, Phase);
+        static constexpr int CYCLE = 360 / gcd(Phase, 360);
+        static constexpr int SLICE_SIZE = LINE_PERIOD + GBA_SCREEN_HEIGHT - 1;
+
+        static_assert(Frequency > 0 && Frequency < 360, "Invalid wobble frequency");
+        static_assert(Phase > 0 && Phase < 360, "Invalid wobble phase");
+
+        void init(const bn::affine_bg_mat_attributes& base_attributes) {
+            for(int slice = 0; slice < SLICES; ++slice) {
+                for(int index = 0; index < SLICE_SIZE; ++index) {
+                    int degrees_angle = (Phase * slice + Frequency * index) % 360;
+                    bn::fixed rotation = bn::degrees_lut_sin(degrees_angle) * Amplitude;
+                    if (rotation < 0) rotation += 360;
+                    this->attributes[slice][index] = base_attributes;
+                    this->attributes[slice][index].set_rotation_angle(rotation);
+                }
+            }
+        }
+        // frame must be in [0, CYCLE)
+        bn::span<const bn::affine_bg_mat_attributes> slice(int frame) const {
+            int start = (1 + (frame / SLICES) * LINE_SHIFT) % LINE_PERIOD;
+            return bn::span<const bn::affine_bg_mat_attributes>(&this->attributes[frame % SLICES][start], GBA_SCREEN_HEIGHT);
+        }
+    private:
+        bn::affine_bg_mat_attributes attributes[SLICES][SLICE_SIZE];
+};
+
+// Frequency 16, phase 4 (3-4), amplitude 1
+using OceanWobble = Wobble<16, 4, 1>;
+extern OceanWobble ocean_wobble;   // EWRAM
+
+/*
+    Ocean backdrop shared by every scene.
+    Created once by main() and borrowed by title(), game() and results() : its
+    tiles, window and HBE stay alive and the wobble keeps running between screens.
+*/
+class OceanBackdrop {
+    private:
+        bn::optional<bn::affine_bg_ptr> bg;
+        bn::optional<bn::rect_window> internal_window;
+        bn::optional<bn::affine_bg_mat_attributes_hbe_ptr> attributes_hbe;
+        int frame;   // in [0, CYCLE) of the wobble
+    public:
+        OceanBackdrop();
+        template<class WobbleType>
+        void update(const WobbleType& wobble) {
+            if(++this->frame == WobbleType::CYCLE) this->frame = 0;
+            this->attributes_hbe->set_attributes_ref(wobble.slice(this->frame));
+        }
+};
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+/*
+    Benchmark ROM, built by "make bench" with -DBENCH_ENABLED=1
+    Every scene runs on its own with a scripted input. The CPU usage of each frame and the
+    result of the on-target checks are kept in RAM, so that logging doesn't weigh on the
+    measured frames. After one title, game and results, bench_exit() writes them to the
+    mGBA debug log ("BENCH <scene> <usage>", 4096 = a whole frame, and "BENCH check <name>
+    ok" or "failed"), then leaves mgba-rom-test with the BENCH_EXIT_SWI software interrupt.
+    tools/bench_report.py reads the log.
+*/
+#ifndef BENCH_ENABLED
+    #define BENCH_ENABLED 0
+#endif
+
+#define BENCH_EXIT_SWI          0x1F    // mgba-rom-test --exit-swi
+#define BENCH_TITLE_FRAMES      (60*14) // Title frames, fish swim from frame 60*4-32
+#define BENCH_GAME_FRAMES       (60*60) // Game frames, with FISH_MAX_NUMBER fish
+#define BENCH_SAMPLES_MAX       (BENCH_TITLE_FRAMES + BENCH_GAME_FRAMES + 512)  // With the title intro and the results
+#define BENCH_RUNS_MAX          8       // Scene changes
+#define BENCH_CHECKS_MAX        8
+
+#if BENCH_ENABLED
+
+#define BENCH_FRAME(scene)  bench_frame(scene)
+#define BENCH_CHECK(name, condition)  bench_check(name, condition)
+
+// Keeps the CPU usage of the last frame, scene : string literal
+void bench_frame(const char* scene);
+void bench_check(const char* name, bool ok);
+// Logs the frames and checks, then ends the emulator run
+[[noreturn]] void bench_exit();
+
+#else
+
+#define BENCH_FRAME(scene)  ((void)0)
+#define BENCH_CHECK(name, condition)  ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef CAMERA_CONTROLLER_H
+#define CAMERA_CONTROLLER_H
+
+#include "bn_fixed.h"
+#include "bn_camera_ptr.h"
+#include "bn_regular_bg_ptr.h"
+
+#define CAMERA_DEAD_ZONE_X      16  // The target moves freely in a 32x24 px box around the center
+#define CAMERA_DEAD_ZONE_Y      12
+#define CAMERA_SMOOTHING_SHIFT  2   // Each frame, the camera catches up 1/4 of the distance out of the box
+#define CAMERA_SHAKE_FRAMES     16
+#define CAMERA_SHAKE_AMPLITUDE  3
+
+/*
+    Camera of a level
+    The clamp bounds come from the level size once, when the controller is created. The
+    camera follows its target with a dead zone and a smoothing, and is only written when
+    it moves : camera-attached sprites and backgrounds are left alone otherwise.
+    A shake moves the level background by a display offset, not the camera : no sprite is
+    repositioned while shaking.
+*/
+class CameraController {
+    private:
+        bn::camera_ptr* camera;
+        bn::regular_bg_ptr* shake_bg;
+        bn::fixed shake_x;              // Position of shake_bg out of the shakes
+        bn::fixed shake_y;
+        bn::fixed x;
+        bn::fixed y;
+        bn::fixed min_x;
+        bn::fixed max_x;
+        bn::fixed min_y;
+        bn::fixed max_y;
+        unsigned char shake_index;      // CAMERA_SHAKE_FRAMES : no shake
+
+        static bn::fixed follow(bn::fixed position, bn::fixed target, int dead_zone);
+
+    public:
+        // The level, of level_width x level_height px, is centered on (0, 0), level_bg shakes
+        CameraController(bn::camera_ptr& cam, bn::regular_bg_ptr& level_bg, int level_width, int level_height,
+                         bn::fixed target_x, bn::fixed target_y);
+
+        bn::fixed getX() const {
+            return(this->x);
+        }
+        bn::fixed getY() const {
+            return(this->y);
+        }
+        // Starts a shake, unless one is running
+        void shake();
+        void update(bn::fixed target_x, bn::fixed target_y);
+};
+
+#endif
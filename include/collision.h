@@ -0,0 +1,33 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "bn_common.h"
+#include "bn_fixed.h"
+#include "collision_grid.h"
+
+// Returns every TILE_* flag of the cell under (x, y), read from the packed collision layer
+BN_CODE_IWRAM unsigned char tile_flags_at(bn::fixed x, bn::fixed y, const CollisionGrid& grid);
+
+/*
+    Swept box collision
+    The box [x-half_size, x+half_size) moves by dx then by dy (the y sweep starts from the
+    unmoved x, like the former probes). Only the cells entered by the leading edge are
+    read, so nothing is skipped whatever the speed.
+    normal_x / normal_y are the contact normals (-1, 0 or 1) of the first wall hit on each
+    axis, spike_flags holds the TILE_* flags of the first spike under the center or crossed.
+    Compiled as ARM code in IWRAM, as tile_flags_at().
+*/
+struct CollisionContact {
+    signed char normal_x;
+    signed char normal_y;
+    unsigned char spike_flags;
+};
+
+BN_CODE_IWRAM CollisionContact sweep_box(bn::fixed x, bn::fixed y, bn::fixed dx, bn::fixed dy, int half_size, const CollisionGrid& grid);
+
+#endif
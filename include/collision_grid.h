@@ -0,0 +1,50 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+
+/*
+    Tile flags, one nibble per cell
+*/
+#define TILE_FLAG_SOLID     0x01
+#define TILE_FLAG_SPIKE     0x02
+#define TILE_PUSH_SHIFT     2
+#define TILE_PUSH_MASK      (3 << TILE_PUSH_SHIFT)
+#define TILE_PUSH_LEFT      (0 << TILE_PUSH_SHIFT)
+#define TILE_PUSH_RIGHT     (1 << TILE_PUSH_SHIFT)
+#define TILE_PUSH_UP        (2 << TILE_PUSH_SHIFT)
+#define TILE_PUSH_DOWN      (3 << TILE_PUSH_SHIFT)
+
+/*
+    Packed collision layer of a level, generated by tools/collision_tool.py from the
+    rules in collisions/<level>.json (see the generated collision_items_<level>.h).
+    Two cells per byte : even columns in the low nibble, odd columns in the high one.
+*/
+class CollisionGrid {
+    private:
+        const unsigned char* cells;
+        int grid_columns;
+        int grid_rows;
+    public:
+        constexpr CollisionGrid(const unsigned char* cells_ref, int columns, int rows) :
+            cells(cells_ref),
+            grid_columns(columns),
+            grid_rows(rows) {
+        }
+        constexpr int columns() const {
+            return(this->grid_columns);
+        }
+        constexpr int rows() const {
+            return(this->grid_rows);
+        }
+        // column and row must be inside the grid
+        constexpr unsigned char flags(int column, int row) const {
+            unsigned char pair = this->cells[(row * this->grid_columns + column) >> 1];
+            return((column & 1) ? pair >> 4 : pair & 0x0F);
+        }
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef FISH_KERNEL_H
+#define FISH_KERNEL_H
+
+#include "bn_common.h"
+#include "bn_fixed.h"
+
+#define FISH_STATE_APPEARING    0
+#define FISH_STATE_NORMAL       1
+#define FISH_STATE_DYING        2
+#define FISH_STATE_DEAD         3
+#define FISH_STATE_FREE         4
+
+#define DIRECTION_UP            0
+#define DIRECTION_UP_RIGHT      1
+#define DIRECTION_RIGHT         2
+#define DIRECTION_DOWN_RIGHT    3
+#define DIRECTION_DOWN          4
+#define DIRECTION_DOWN_LEFT     5
+#define DIRECTION_LEFT          6
+#define DIRECTION_UP_LEFT       7
+#define DIRECTION_NONE          8
+#define DIRECTION_COUNT         9
+
+#define FISH_CULLED_PERIOD      4   // Fish out of view are moved once every 4 frames (must be a power of 2)
+
+/*
+    Fish movement tables
+    Unit vector of each direction (diagonals are normalized, so every fish swims at its
+    speed whatever its direction) and direction after bouncing on a left / right bound
+    (reflect_x) or on a top / bottom bound (reflect_y).
+*/
+constexpr bn::fixed fish_direction_x[DIRECTION_COUNT] = {
+    0, 0.70710678, 1, 0.70710678, 0, -0.70710678, -1, -0.70710678, 0
+};
+
+constexpr bn::fixed fish_direction_y[DIRECTION_COUNT] = {
+    -1, -0.70710678, 0, 0.70710678, 1, 0.70710678, 0, -0.70710678, 0
+};
+
+constexpr unsigned char fish_reflect_x[DIRECTION_COUNT] = {
+    DIRECTION_UP, DIRECTION_UP_LEFT, DIRECTION_LEFT, DIRECTION_DOWN_LEFT,
+    DIRECTION_DOWN, DIRECTION_DOWN_RIGHT, DIRECTION_RIGHT, DIRECTION_UP_RIGHT, DIRECTION_NONE
+};
+
+constexpr unsigned char fish_reflect_y[DIRECTION_COUNT] = {
+    DIRECTION_DOWN, DIRECTION_DOWN_RIGHT, DIRECTION_RIGHT, DIRECTION_UP_RIGHT,
+    DIRECTION_UP, DIRECTION_UP_LEFT, DIRECTION_LEFT, DIRECTION_DOWN_LEFT, DIRECTION_NONE
+};
+
+/*
+    Nearest of the 8 directions to a (dx, dy) vector, without division nor square root :
+    a vector is straight when one of its components is smaller than tan(22.5°) ~ 0.4142
+    times the other one.
+*/
+constexpr unsigned char fish_direction_from(bn::fixed dx, bn::fixed dy) {
+    bn::fixed abs_x = dx < 0 ? -dx : dx;
+    bn::fixed abs_y = dy < 0 ? -dy : dy;
+    if(abs_x == 0 && abs_y == 0) return(DIRECTION_NONE);
+    if(abs_y < abs_x * bn::fixed(0.4142)) return(dx > 0 ? DIRECTION_RIGHT : DIRECTION_LEFT);
+    if(abs_x < abs_y * bn::fixed(0.4142)) return(dy > 0 ? DIRECTION_DOWN : DIRECTION_UP);
+    if(dx > 0) return(dy > 0 ? DIRECTION_DOWN_RIGHT : DIRECTION_UP_RIGHT);
+    return(dy > 0 ? DIRECTION_DOWN_LEFT : DIRECTION_UP_LEFT);
+}
+
+/*
+    World bounds of the fish, computed once per level
+*/
+struct FishBounds {
+    bn::fixed left;
+    bn::fixed right;
+    bn::fixed top;
+    bn::fixed bottom;
+};
+
+/*
+    Fish arrays (structure of arrays of a fish pool) processed by fish_move_kernel()
+*/
+struct FishBatch {
+    bn::fixed* x;
+    bn::fixed* y;
+    bn::fixed* speed_x;
+    bn::fixed* speed_y;
+    unsigned short* timer;
+    unsigned char* direction;
+    const unsigned char* state;
+    const unsigned char* awake;         // Moved every frame
+    unsigned char* expired;     // Output : indexes of the fish whose timer has expired
+    int count;
+    int culled_phase;           // Culled fish with (index % FISH_CULLED_PERIOD) == culled_phase are moved
+};
+
+/*
+    Moves every swimming fish of the batch by its velocity, bounces it on the world bounds
+    and decrements its timer. Culled fish (not awake) are only moved on their phase
+    frame, by FISH_CULLED_PERIOD steps at once. Compiled as ARM code in IWRAM.
+    Returns the number of fish moved, expired_count receives the number of expired indexes.
+*/
+BN_CODE_IWRAM int fish_move_kernel(const FishBatch& batch, const FishBounds& bounds, int& expired_count);
+
+#endif
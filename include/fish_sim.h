@@ -0,0 +1,492 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef FISH_SIM_H
+#define FISH_SIM_H
+
+#include "bn_fixed.h"
+#include "bn_random.h"
+
+#include "world.h"
+#include "collision.h"
+#include "fish_kernel.h"
+#include "spatial_grid.h"
+#include "player_core.h"
+
+#define FISH_TYPE_NORMAL        0
+#define FISH_TYPE_SPEED         1
+#define FISH_TYPE_CONFUSION     2
+#define FISH_TYPE_DEFORMATION   3
+#define FISH_TYPE_SUPER         4
+#define FISH_TYPE_DEATH         5
+#define FISH_TYPE_COUNT         6
+#define FISH_BOXSIZE 12
+#define SUPER_FISH_CHANCE 30
+
+#define FISH_BEHAVIOR_NONE      0x00
+#define FISH_BEHAVIOR_SCHOOL    0x01    // Follows the fish of its type around it
+#define FISH_BEHAVIOR_FLEE      0x02    // Swims away from the piranha
+#define FISH_BEHAVIOR_COUNT     2       // One index list per flag : list n holds the fish with flag 1 << n
+#define FISH_LIST_SCHOOL        0
+#define FISH_LIST_FLEE          1
+#define FISH_FLEE_RADIUS        48
+#define FISH_SCHOOL_RADIUS      32
+#define FISH_SCHOOL_NEIGHBOURS  6       // Neighbours looked at, at most
+#define FISH_STEER_PERIOD       4       // A schooling fish steers once every 4 frames
+#define FISH_GRID_MAX_CELLS     256     // 512x512 level with 32px cells
+#define FISH_VIEW_MARGIN        24      // A fish is in view within the screen plus this margin...
+#define FISH_VIEW_HYSTERESIS    16      // ...and leaves it beyond the margin plus this one
+#define FISH_AWAKE_RADIUS       (FISH_FLEE_RADIUS + 32)     // Fish around the threat are never culled
+
+// Room for a culled fish jump (FISH_CULLED_PERIOD steps of 4 px at most) and the piranha moves meanwhile
+static_assert(FISH_AWAKE_RADIUS - FISH_FLEE_RADIUS >= 2 * FISH_CULLED_PERIOD * 4, "Fish awake radius too small");
+
+#ifndef FISH_KERNEL_STATS
+    #define FISH_KERNEL_STATS   0       // 1 : logs the fish kernel cost in cycles per fish
+#endif
+
+#if FISH_KERNEL_STATS
+    #include "bn_log.h"
+    #include "bn_timer.h"
+    #include "bn_timers.h"
+    #include "profiler.h"
+#endif
+
+/*
+    Fish types description
+    Spawning, movement and eating are all driven by this table : a new fish type is
+    a new line (and a FISH_TYPE_* index), not a new class. Sprites of each type are
+    given by the presentation.
+*/
+struct FishDescriptor {
+    bn::fixed speed_min;
+    bn::fixed speed_max;
+    unsigned char move_min;         // Swimming time range, in frames
+    unsigned char move_max;
+    unsigned char wait_min;         // Waiting time range, in frames (0 : never waits)
+    unsigned char wait_max;
+    unsigned char spawn_weight;     // Weight in createFish() random pick (0 : special spawn only)
+    char effect;                    // PJ_FX_* given to the player when eaten
+    signed char life_delta;         // Life given (or taken) when eaten
+    unsigned char behavior;         // FISH_BEHAVIOR_* flags
+};
+
+constexpr FishDescriptor fish_descriptors[FISH_TYPE_COUNT] = {
+    // speed       move     wait     weight  effect          life    behavior
+    { 0.5, 1,     50, 100, 50, 100, 1,      PJ_FX_NORMAL,   0,      FISH_BEHAVIOR_SCHOOL },    // normal
+    { 1.5, 2,     50, 100, 50, 100, 1,      PJ_FX_SPEED,    0,      FISH_BEHAVIOR_FLEE },      // speed
+    { 0.5, 1,     50, 100, 50, 100, 1,      PJ_FX_CONFUS,   0,      FISH_BEHAVIOR_SCHOOL },    // confusion
+    { 0.3, 0.6,   50, 100, 50, 100, 1,      PJ_FX_DEFORM,   0,      FISH_BEHAVIOR_NONE },      // deformation
+    { 2.5, 3,     50, 100, 0,  0,   0,      PJ_FX_NORMAL,   8,      FISH_BEHAVIOR_FLEE },      // super
+    { 0.5, 1,     50, 100, 50, 100, 0,      PJ_FX_NORMAL,   -2,     FISH_BEHAVIOR_NONE },      // death
+};
+
+constexpr bool valid_fish_descriptors() {
+    for(const FishDescriptor& descriptor : fish_descriptors) {
+        if(descriptor.speed_min > descriptor.speed_max ||
+           descriptor.move_min >= descriptor.move_max || descriptor.wait_min > descriptor.wait_max) {
+            return(false);
+        }
+    }
+    return(true);
+}
+
+static_assert(valid_fish_descriptors(), "Invalid fish descriptors");
+static_assert(FISH_BEHAVIOR_SCHOOL == 1 << FISH_LIST_SCHOOL && FISH_BEHAVIOR_FLEE == 1 << FISH_LIST_FLEE, "Invalid fish behavior lists");
+
+/*
+    Context shared by every fish of a scene
+*/
+struct FishContext {
+    bn::random* random;
+    const CollisionGrid* grid;
+    short width;
+    short height;
+    FishBounds bounds;
+};
+
+inline FishContext create_fish_context(bn::random& rand, int width, int height, const CollisionGrid& collision_grid) {
+    FishContext context;
+    context.random = &rand;
+    context.grid = &collision_grid;
+    context.width = width;
+    context.height = height;
+    context.bounds.left = -width/2+CAM_OFFSET_LEFT_LIMIT;
+    context.bounds.right = width/2-CAM_OFFSET_RIGHT_LIMIT;
+    context.bounds.top = -height/2+CAM_OFFSET_UP_LIMIT;
+    context.bounds.bottom = height/2-CAM_OFFSET_DOWN_LIMIT;
+    return(context);
+}
+
+/*
+    Fixed capacity fish simulation
+    Fish state is stored as structure of arrays and free slots are kept in a stack.
+    Fish inside the view (the screen around the given center, plus FISH_VIEW_MARGIN) or
+    around the threat (FISH_AWAKE_RADIUS) are awake and moved every frame, the others once
+    every FISH_CULLED_PERIOD frames : no culled fish can be eaten or flee from a position
+    frames old. The presentation only gives a sprite to the fish in view.
+    Movement of every fish is done in one pass by fish_move_kernel() (IWRAM).
+    Fish are also indexed in a SpatialGrid, used for the piranha queries and to
+    steer schooling fish without looking at every pair of fish. The fish of each
+    behavior are kept in an index list, filled at spawn : the behavior passes only
+    walk their own list, without looking up the type of every fish.
+*/
+template<int Capacity>
+class FishSim {
+    private:
+        FishContext* context;
+        bn::fixed x[Capacity];
+        bn::fixed y[Capacity];
+        bn::fixed speed[Capacity];
+        bn::fixed speed_x[Capacity];
+        bn::fixed speed_y[Capacity];
+        unsigned short timer[Capacity];
+        unsigned short timer_init[Capacity];
+        unsigned short timer_wait[Capacity];
+        unsigned char state_timer[Capacity];
+        unsigned char direction[Capacity];
+        unsigned char state[Capacity];
+        unsigned char type[Capacity];
+        unsigned char visible[Capacity];
+        unsigned char awake[Capacity];      // Moved every frame : in view or around the threat
+        unsigned char generation[Capacity];
+        unsigned char free_slots[Capacity];
+        unsigned char expired[Capacity];
+        unsigned char behavior_fish[FISH_BEHAVIOR_COUNT][Capacity];
+        unsigned char behavior_position[FISH_BEHAVIOR_COUNT][Capacity];   // Place of a fish in each list
+        int behavior_count[FISH_BEHAVIOR_COUNT];
+        int free_count;
+        SpatialGrid<Capacity, FISH_GRID_MAX_CELLS> spatial;
+        bool threat = false;
+        bn::fixed threat_x;
+        bn::fixed threat_y;
+        unsigned char frame = 0;
+#if FISH_KERNEL_STATS
+        int stats_frames = 0;
+        int stats_ticks = 0;
+        int stats_fish = 0;
+#endif
+
+        static_assert(Capacity <= 255, "Invalid fish pool capacity");
+
+        bool inView(int index, bn::fixed view_x, bn::fixed view_y, int margin) const {
+            bn::fixed screen_x = this->x[index] - view_x;
+            bn::fixed screen_y = this->y[index] - view_y;
+            return(screen_x > -(GBA_SCREEN_WIDTH/2 + margin) && screen_x < GBA_SCREEN_WIDTH/2 + margin &&
+                   screen_y > -(GBA_SCREEN_HEIGHT/2 + margin) && screen_y < GBA_SCREEN_HEIGHT/2 + margin);
+        }
+        bool nearThreat(int index) const {
+            if(!this->threat) return(false);
+            bn::fixed dx = this->x[index] - this->threat_x;
+            bn::fixed dy = this->y[index] - this->threat_y;
+            return(dx > -FISH_AWAKE_RADIUS && dx < FISH_AWAKE_RADIUS && dy > -FISH_AWAKE_RADIUS && dy < FISH_AWAKE_RADIUS);
+        }
+        void setDirection(int index, unsigned char new_direction) {
+            this->direction[index] = new_direction;
+            this->speed_x[index] = this->speed[index] * fish_direction_x[new_direction];
+            this->speed_y[index] = this->speed[index] * fish_direction_y[new_direction];
+        }
+        // Swims away from the threat
+        void flee(int index) {
+            unsigned char new_direction = fish_direction_from(this->x[index] - this->threat_x, this->y[index] - this->threat_y);
+            if(new_direction == DIRECTION_NONE || new_direction == this->direction[index]) return;
+            if(this->direction[index] == DIRECTION_NONE) this->timer[index] = this->timer_init[index];
+            this->setDirection(index, new_direction);
+        }
+        // Alignment with the swimming neighbours of the same type, plus cohesion toward them
+        void school(int index) {
+            bn::fixed fish_x = this->x[index];
+            bn::fixed fish_y = this->y[index];
+            bn::fixed sum_x = this->speed_x[index];
+            bn::fixed sum_y = this->speed_y[index];
+            bn::fixed offset_x;
+            bn::fixed offset_y;
+            int neighbours = 0;
+            this->spatial.query(fish_x, fish_y, FISH_SCHOOL_RADIUS, [&](int other) {
+                if(other == index || this->type[other] != this->type[index] || this->state[other] != FISH_STATE_NORMAL) return(true);
+                bn::fixed dx = this->x[other] - fish_x;
+                bn::fixed dy = this->y[other] - fish_y;
+                if(dx < -FISH_SCHOOL_RADIUS || dx > FISH_SCHOOL_RADIUS || dy < -FISH_SCHOOL_RADIUS || dy > FISH_SCHOOL_RADIUS) return(true);
+                sum_x += this->speed_x[other];
+                sum_y += this->speed_y[other];
+                offset_x += dx;
+                offset_y += dy;
+                neighbours += 1;
+                return(neighbours < FISH_SCHOOL_NEIGHBOURS);
+            });
+            if(neighbours == 0) return;
+            // Cohesion : 1/16 of the mean offset
+            sum_x += bn::fixed::from_data((offset_x / neighbours).data() >> 4);
+            sum_y += bn::fixed::from_data((offset_y / neighbours).data() >> 4);
+            unsigned char new_direction = fish_direction_from(sum_x, sum_y);
+            if(new_direction != DIRECTION_NONE && new_direction != this->direction[index]) this->setDirection(index, new_direction);
+        }
+        void addBehaviors(int index) {
+            unsigned char behavior = fish_descriptors[this->type[index]].behavior;
+            for(int list = 0; list < FISH_BEHAVIOR_COUNT; list++) {
+                if(!(behavior & (1 << list))) continue;
+                this->behavior_position[list][index] = this->behavior_count[list];
+                this->behavior_fish[list][this->behavior_count[list]] = index;
+                this->behavior_count[list] += 1;
+            }
+        }
+        // The last fish of the list takes the place of the removed one
+        void removeBehaviors(int index) {
+            unsigned char behavior = fish_descriptors[this->type[index]].behavior;
+            for(int list = 0; list < FISH_BEHAVIOR_COUNT; list++) {
+                if(!(behavior & (1 << list))) continue;
+                this->behavior_count[list] -= 1;
+                int last = this->behavior_fish[list][this->behavior_count[list]];
+                int position = this->behavior_position[list][index];
+                this->behavior_fish[list][position] = last;
+                this->behavior_position[list][last] = position;
+            }
+        }
+        // Direction choice when the timer of a swimming fish expires
+        void expire(int index) {
+            bool collision = (tile_flags_at(this->x[index], this->y[index], *this->context->grid) & (TILE_FLAG_SOLID | TILE_FLAG_SPIKE)) != 0;
+            if(this->direction[index] == DIRECTION_NONE || this->timer_wait[index] == 0 || collision) {
+                if (!collision) this->setDirection(index, this->context->random->get_int(8));
+                this->timer[index] = this->timer_init[index];
+            } else {
+                this->setDirection(index, DIRECTION_NONE);
+                this->timer[index] = this->timer_wait[index];
+            }
+        }
+
+    public:
+        FishSim(FishContext& fish_context) :
+            spatial(fish_context.width, fish_context.height) {
+            this->context = &fish_context;
+            this->free_count = Capacity;
+            for(int list = 0; list < FISH_BEHAVIOR_COUNT; list++) {
+                this->behavior_count[list] = 0;
+            }
+            for(int index = 0; index < Capacity; index++) {
+                this->state[index] = FISH_STATE_FREE;
+                this->free_slots[index] = Capacity - 1 - index;
+                this->visible[index] = false;
+                this->awake[index] = false;
+                this->generation[index] = 0;
+            }
+        }
+        int capacity() const {
+            return(Capacity);
+        }
+        int size() const {
+            return(Capacity - this->free_count);
+        }
+        bool active(int index) const {
+            return(this->state[index] != FISH_STATE_FREE);
+        }
+        unsigned char getType(int index) const {
+            return(this->type[index]);
+        }
+        char getState(int index) const {
+            return(this->state[index]);
+        }
+        // Frames left in the appearing / dying state
+        unsigned char getStateTimer(int index) const {
+            return(this->state_timer[index]);
+        }
+        unsigned char getDirection(int index) const {
+            return(this->direction[index]);
+        }
+        bn::fixed getX(int index) const {
+            return(this->x[index]);
+        }
+        bn::fixed getY(int index) const {
+            return(this->y[index]);
+        }
+        bool isVisible(int index) const {
+            return(this->visible[index]);
+        }
+        // Changes each time the slot is given to a new fish
+        unsigned char getGeneration(int index) const {
+            return(this->generation[index]);
+        }
+        // visitor(index) is called for the fish of the cells around (x, y), returns false to stop
+        template<class Visitor>
+        void query(bn::fixed x, bn::fixed y, int radius, Visitor&& visitor) const {
+            this->spatial.query(x, y, radius, visitor);
+        }
+        // Fish with FISH_BEHAVIOR_FLEE swim away from this point (the piranha)
+        void setThreat(bn::fixed x, bn::fixed y) {
+            this->threat = true;
+            this->threat_x = x;
+            this->threat_y = y;
+        }
+        void clearThreat() {
+            this->threat = false;
+        }
+        bool collision(int index, bn::fixed pj_x, bn::fixed pj_y) const {
+            return ((pj_x > this->x[index] - FISH_BOXSIZE) &&
+                    (pj_x < this->x[index] + FISH_BOXSIZE) &&
+                    (pj_y > this->y[index] - FISH_BOXSIZE) &&
+                    (pj_y < this->y[index] + FISH_BOXSIZE));
+        }
+        void kill(int index) {
+            this->state[index] = FISH_STATE_DYING;
+            this->state_timer[index] = 30;
+        }
+        // Returns the slot index, or -1 if the pool is full
+        int spawn(unsigned char fish_type, bn::fixed init_x, bn::fixed init_y, bn::fixed speed_value, unsigned short timer_value, unsigned short timer_wait_value) {
+            if(this->free_count == 0) return(-1);
+            this->free_count -= 1;
+            int index = this->free_slots[this->free_count];
+
+            // In view from the next update()
+            this->visible[index] = false;
+            this->awake[index] = false;
+            this->generation[index] += 1;
+            this->x[index] = init_x;
+            this->y[index] = init_y;
+            this->speed[index] = speed_value;
+            this->timer_init[index] = timer_value;
+            this->timer_wait[index] = timer_wait_value;
+            this->timer[index] = timer_value;
+            this->setDirection(index, this->context->random->get_int(8));
+            this->state[index] = FISH_STATE_APPEARING;
+            this->state_timer[index] = 30;
+            this->type[index] = fish_type;
+            this->addBehaviors(index);
+            this->spatial.insert(index, init_x, init_y);
+            return(index);
+        }
+        void release(int index) {
+            this->state[index] = FISH_STATE_FREE;
+            this->visible[index] = false;
+            this->awake[index] = false;
+            this->removeBehaviors(index);
+            this->spatial.remove(index);
+            this->free_slots[this->free_count] = index;
+            this->free_count += 1;
+        }
+        // (view_x, view_y) : center of the view, the camera position
+        void update(bn::fixed view_x, bn::fixed view_y) {
+            FishBatch batch;
+            batch.x = this->x;
+            batch.y = this->y;
+            batch.speed_x = this->speed_x;
+            batch.speed_y = this->speed_y;
+            batch.timer = this->timer;
+            batch.direction = this->direction;
+            batch.state = this->state;
+            batch.awake = this->awake;
+            batch.expired = this->expired;
+            batch.count = Capacity;
+            batch.culled_phase = this->frame & (FISH_CULLED_PERIOD - 1);
+
+            int expired_count;
+#if FISH_KERNEL_STATS
+            bn::timer kernel_timer;
+            this->stats_fish += fish_move_kernel(batch, this->context->bounds, expired_count);
+            this->stats_ticks += kernel_timer.elapsed_ticks();
+            this->stats_frames += 1;
+            if(this->stats_frames == 64) {
+                if(this->stats_fish) {
+                    int cycles = this->stats_ticks * (GBA_CYCLES_PER_FRAME / bn::timers::ticks_per_frame());
+                    BN_LOG("Fish kernel: ", cycles / this->stats_fish, " cycles per fish (", this->stats_fish / 64, " fish)");
+                }
+                this->stats_frames = 0;
+                this->stats_ticks = 0;
+                this->stats_fish = 0;
+            }
+#else
+            fish_move_kernel(batch, this->context->bounds, expired_count);
+#endif
+
+            for(int expired_index = 0; expired_index < expired_count; expired_index++) {
+                this->expire(this->expired[expired_index]);
+            }
+
+            // Behaviors, each on its own list
+            if(this->threat) {
+                const unsigned char* flee_fish = this->behavior_fish[FISH_LIST_FLEE];
+                for(int position = 0; position < this->behavior_count[FISH_LIST_FLEE]; position++) {
+                    int index = flee_fish[position];
+                    if(this->state[index] != FISH_STATE_NORMAL) continue;
+                    bn::fixed dx = this->x[index] - this->threat_x;
+                    bn::fixed dy = this->y[index] - this->threat_y;
+                    if(dx > -FISH_FLEE_RADIUS && dx < FISH_FLEE_RADIUS && dy > -FISH_FLEE_RADIUS && dy < FISH_FLEE_RADIUS) this->flee(index);
+                }
+            }
+            // Schooling fish are spread over FISH_STEER_PERIOD frames
+            const unsigned char* school_fish = this->behavior_fish[FISH_LIST_SCHOOL];
+            for(int position = this->frame % FISH_STEER_PERIOD; position < this->behavior_count[FISH_LIST_SCHOOL]; position += FISH_STEER_PERIOD) {
+                int index = school_fish[position];
+                if(this->state[index] == FISH_STATE_NORMAL && this->direction[index] != DIRECTION_NONE) {
+                    this->school(index);
+                }
+            }
+            int culled_phase = this->frame & (FISH_CULLED_PERIOD - 1);
+            this->frame += 1;
+
+            for(int index = 0; index < Capacity; index++) {
+                if(this->state[index] == FISH_STATE_FREE || this->state[index] == FISH_STATE_DEAD) continue;
+
+                if(this->state[index] == FISH_STATE_APPEARING) {
+                    this->state_timer[index] -= 1;
+                    if(this->state_timer[index] == 0) {
+                        this->state[index] = FISH_STATE_NORMAL;
+                    }
+                }
+                else if(this->state[index] == FISH_STATE_DYING) {
+                    this->state_timer[index] -= 1;
+                    if(this->state_timer[index] == 0) {
+                        this->state[index] = FISH_STATE_DEAD;
+                    }
+                }
+
+                // Culling : culled fish only move, and are checked, on their phase frame
+                if(!this->awake[index] && (index & (FISH_CULLED_PERIOD - 1)) != culled_phase) continue;
+                this->spatial.move(index, this->x[index], this->y[index]);
+                int margin = this->visible[index] ? FISH_VIEW_MARGIN + FISH_VIEW_HYSTERESIS : FISH_VIEW_MARGIN;
+                this->visible[index] = this->inView(index, view_x, view_y, margin);
+                this->awake[index] = this->visible[index] || this->nearThreat(index);
+            }
+        }
+};
+
+/*
+    Spawn a fish of the given type at a random place of the level
+*/
+template<int Capacity>
+int spawnFish(FishSim<Capacity>& pool, FishContext& context, unsigned char fish_type) {
+    const FishDescriptor& descriptor = fish_descriptors[fish_type];
+    bn::random& rand = *context.random;
+    bn::fixed x = rand.get_int(context.width)-context.width/2;
+    bn::fixed y = rand.get_int(context.height)-context.height/2;
+    bn::fixed speed = rand.get_fixed(descriptor.speed_min, descriptor.speed_max);
+    unsigned short timer_value = rand.get_int(descriptor.move_min, descriptor.move_max);
+    unsigned short timer_wait_value = descriptor.wait_max == 0 ? 0 : rand.get_int(descriptor.wait_min, descriptor.wait_max);
+    return(pool.spawn(fish_type, x, y, speed, timer_value, timer_wait_value));
+}
+
+// extend : last fish type that can be picked (FISH_TYPE_NORMAL to FISH_TYPE_DEFORMATION)
+template<int Capacity>
+int createFish(FishSim<Capacity>& pool, FishContext& context, int extend) {
+    int super = context.random->get_int(SUPER_FISH_CHANCE);
+    if(super == 7) return(spawnFish(pool, context, FISH_TYPE_SUPER));
+
+    int total_weight = 0;
+    for(int type = 0; type <= extend; type++) {
+        total_weight += fish_descriptors[type].spawn_weight;
+    }
+    int pick = context.random->get_int(total_weight);
+    int type = 0;
+    while(pick >= fish_descriptors[type].spawn_weight) {
+        pick -= fish_descriptors[type].spawn_weight;
+        type++;
+    }
+    return(spawnFish(pool, context, type));
+}
+
+template<int Capacity>
+int createDeathFish(FishSim<Capacity>& pool, FishContext& context) {
+    return(spawnFish(pool, context, FISH_TYPE_DEATH));
+}
+
+#endif
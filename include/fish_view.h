@@ -0,0 +1,210 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef FISH_VIEW_H
+#define FISH_VIEW_H
+
+#include "bn_optional.h"
+#include "bn_camera_ptr.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_item.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_sprite_items_fish_normal.h"
+#include "bn_sprite_items_fish_speed.h"
+#include "bn_sprite_items_fish_deformation.h"
+#include "bn_sprite_items_fish_occoured.h"
+#include "bn_sprite_items_fish_confusion.h"
+#include "bn_sprite_items_fish_death.h"
+
+#include "fish_sim.h"
+
+#define FISH_ANIMATION_WAIT     4       // Updates skipped between frames, as the wait of bn::sprite_animate_action
+#define FISH_ANIMATION_STEPS    4
+#define FISH_ANIMATION_FRAMES   3       // Graphics of the fish sprites
+#define FISH_ANIMATION_PHASES   2
+#define FISH_ANIMATION_OFFSET   1       // Steps between two phases : 0 1 2 1 against 1 2 1 0, never the same frame
+#define FISH_SPRITE_NONE        255     // Fish without hardware sprite
+#define FISH_SPRITE_ACQUIRE_MAX 8       // Sprites given in one update, at most : a mass spawn is spread over frames
+
+/*
+    Sprite of each fish type (FISH_TYPE_* index), the types themselves are described
+    by fish_descriptors in fish_sim.h
+*/
+constexpr const bn::sprite_item* fish_sprite_items[FISH_TYPE_COUNT] = {
+    &bn::sprite_items::fish_normal,
+    &bn::sprite_items::fish_speed,
+    &bn::sprite_items::fish_confusion,
+    &bn::sprite_items::fish_deformation,
+    &bn::sprite_items::fish_occoured,
+    &bn::sprite_items::fish_death,
+};
+
+/*
+    Animation shared by every fish of a type
+    Each type owns FISH_ANIMATION_PHASES tiles handles playing the 0, 1, 2, 1 cycle, shifted
+    by FISH_ANIMATION_OFFSET steps from one phase to the next so schools don't flap in
+    lockstep. Moving fish point their sprite to one of them : a clock step updates the
+    tiles of every fish of a type at once, whatever the number of fish. A fish that stops
+    keeps the frame of its phase, from the shared idle tiles of each frame.
+*/
+class FishAnimation {
+    private:
+        bn::optional<bn::sprite_tiles_ptr> tiles[FISH_TYPE_COUNT][FISH_ANIMATION_PHASES];
+        bn::optional<bn::sprite_tiles_ptr> idle_tiles[FISH_TYPE_COUNT][FISH_ANIMATION_FRAMES];
+        int clock;
+        int step;
+
+        static constexpr int graphics_index(int animation_step) {
+            constexpr int sequence[FISH_ANIMATION_STEPS] = {0, 1, 2, 1};
+            return(sequence[animation_step % FISH_ANIMATION_STEPS]);
+        }
+
+    public:
+        FishAnimation();
+        // Graphics index shown by a phase now
+        int frame(int phase) const {
+            return(graphics_index(this->step + phase * FISH_ANIMATION_OFFSET));
+        }
+        // Tiles of a fish waiting, appearing or dying, on the frame of its phase
+        const bn::sprite_tiles_ptr& idle(unsigned char type, int phase) const {
+            return(*this->idle_tiles[type][this->frame(phase)]);
+        }
+        const bn::sprite_tiles_ptr& moving(unsigned char type, int phase) const {
+            return(*this->tiles[type][phase]);
+        }
+        void update();
+};
+
+/*
+    Sprites of the fish of a FishSim
+    A hardware sprite from a pool of SpriteCapacity sprites is only given to the fish the
+    simulation has in view, and taken back when it leaves it. A released sprite is kept :
+    the next fish only swaps its tiles. Sprites are animated by the shared FishAnimation.
+*/
+template<int Capacity, int SpriteCapacity>
+class FishView {
+    private:
+        const FishSim<Capacity>* fish;
+        bn::camera_ptr* camera;
+        FishAnimation* animation;
+        bn::optional<bn::sprite_ptr> sprite[SpriteCapacity];
+        unsigned char sprite_free_slots[SpriteCapacity];
+        int sprite_free_count;
+        unsigned char sprite_slot[Capacity];
+        unsigned char sprite_generation[Capacity];
+        bool animated[Capacity];
+        bool flipped[Capacity];
+
+        static_assert(Capacity < FISH_SPRITE_NONE && SpriteCapacity <= Capacity, "Invalid fish view capacity");
+
+        bool moving(int index) const {
+            return(this->fish->getState(index) == FISH_STATE_NORMAL && this->fish->getDirection(index) != DIRECTION_NONE);
+        }
+        // Gives a sprite to a fish entering the view, returns false when every sprite is used
+        bool acquireSprite(int index) {
+            if(this->sprite_free_count == 0) return(false);
+            this->sprite_free_count -= 1;
+            int slot = this->sprite_free_slots[this->sprite_free_count];
+            this->sprite_slot[index] = slot;
+
+            // A new fish in the slot starts facing left
+            if(this->sprite_generation[index] != this->fish->getGeneration(index)) {
+                this->sprite_generation[index] = this->fish->getGeneration(index);
+                this->flipped[index] = false;
+            }
+            this->animated[index] = this->moving(index);
+
+            unsigned char fish_type = this->fish->getType(index);
+            const bn::sprite_item& item = *fish_sprite_items[fish_type];
+            if(this->sprite[slot]) {
+                this->sprite[slot]->set_palette(item.palette_item().create_palette());
+                this->sprite[slot]->set_visible(true);
+            }
+            else {
+                this->sprite[slot] = item.create_sprite(0, 0);
+            }
+            bn::sprite_ptr& fish_sprite = *this->sprite[slot];
+            if(this->animated[index]) fish_sprite.set_tiles(this->animation->moving(fish_type, index % FISH_ANIMATION_PHASES));
+            else fish_sprite.set_tiles(this->animation->idle(fish_type, index % FISH_ANIMATION_PHASES));
+            fish_sprite.set_horizontal_flip(this->flipped[index]);
+            return(true);
+        }
+        // The sprite is hidden but kept for the next fish
+        void releaseSprite(int index) {
+            int slot = this->sprite_slot[index];
+            this->sprite[slot]->set_visible(false);
+            this->sprite_slot[index] = FISH_SPRITE_NONE;
+            this->sprite_free_slots[this->sprite_free_count] = slot;
+            this->sprite_free_count += 1;
+        }
+
+    public:
+        FishView(const FishSim<Capacity>& fish_sim, bn::camera_ptr& cam, FishAnimation& fish_animation) {
+            this->fish = &fish_sim;
+            this->camera = &cam;
+            this->animation = &fish_animation;
+            for(int index = 0; index < Capacity; index++) {
+                this->sprite_slot[index] = FISH_SPRITE_NONE;
+                this->sprite_generation[index] = 0;
+                this->animated[index] = false;
+                this->flipped[index] = false;
+            }
+            this->sprite_free_count = SpriteCapacity;
+            for(int slot = 0; slot < SpriteCapacity; slot++) {
+                this->sprite_free_slots[slot] = SpriteCapacity - 1 - slot;
+            }
+        }
+        // Fish currently holding a hardware sprite
+        int sprites() const {
+            return(SpriteCapacity - this->sprite_free_count);
+        }
+        void update() {
+            const FishSim<Capacity>& fish_sim = *this->fish;
+            bn::fixed camera_x = this->camera->x();
+            bn::fixed camera_y = this->camera->y();
+            int acquired = 0;
+            for(int index = 0; index < Capacity; index++) {
+                bool shown = fish_sim.active(index) && fish_sim.getState(index) != FISH_STATE_DEAD && fish_sim.isVisible(index);
+
+                // Sprite virtualization : the slot may also have been given to a new fish
+                if(this->sprite_slot[index] != FISH_SPRITE_NONE &&
+                   (!shown || this->sprite_generation[index] != fish_sim.getGeneration(index))) {
+                    this->releaseSprite(index);
+                }
+                if(!shown) continue;
+                if(this->sprite_slot[index] == FISH_SPRITE_NONE) {
+                    if(acquired == FISH_SPRITE_ACQUIRE_MAX || !this->acquireSprite(index)) continue;
+                    acquired += 1;
+                }
+                bn::sprite_ptr& fish_sprite = *this->sprite[this->sprite_slot[index]];
+
+                // Blinking while appearing or dying
+                char state = fish_sim.getState(index);
+                bool blink_visible = (state != FISH_STATE_APPEARING && state != FISH_STATE_DYING) || fish_sim.getStateTimer(index) % 2 == 0;
+                if(blink_visible != fish_sprite.visible()) fish_sprite.set_visible(blink_visible);
+
+                // Facing the swimming direction
+                bn::fixed direction_x = fish_direction_x[fish_sim.getDirection(index)];
+                if(direction_x != 0 && (direction_x > 0) != this->flipped[index]) {
+                    this->flipped[index] = direction_x > 0;
+                    fish_sprite.set_horizontal_flip(this->flipped[index]);
+                }
+
+                // Shared animation only while swimming
+                bool moving = this->moving(index);
+                if(moving != this->animated[index]) {
+                    this->animated[index] = moving;
+                    if(moving) fish_sprite.set_tiles(this->animation->moving(fish_sim.getType(index), index % FISH_ANIMATION_PHASES));
+                    else fish_sprite.set_tiles(this->animation->idle(fish_sim.getType(index), index % FISH_ANIMATION_PHASES));
+                }
+
+                // Déplacement du sprite
+                fish_sprite.set_x(fish_sim.getX(index) - camera_x);
+                fish_sprite.set_y(fish_sim.getY(index) - camera_y);
+            }
+        }
+};
+
+#endif
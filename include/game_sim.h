@@ -0,0 +1,101 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef GAME_SIM_H
+#define GAME_SIM_H
+
+#include "bn_fixed.h"
+#include "bn_random.h"
+
+#include "fish_sim.h"
+#include "player_core.h"
+
+#define FISH_MAX_NUMBER 64          // Capacity of the fish pool
+#define FISH_GAME_MAX_NUMBER 20     // Fish in play at most, the difficulty of the game
+#define FISH_DEATH_THRESHOLD 10     // Above this number, new fish are death fish
+#define FISH_START_NUMBER 5
+
+/*
+    One level of the game without presentation : the piranha, the fish and the scoring
+    rules. step() plays a frame from the input bitmask (PJ_INPUT_*), the presentation
+    then reads the state and the player events.
+*/
+template<int Capacity>
+class GameSim {
+    static_assert(Capacity >= FISH_GAME_MAX_NUMBER, "Fish pool smaller than the game");
+
+    public:
+        FishContext fish_context;
+        FishSim<Capacity> fish;
+        PlayerCore player;
+        int fish_points = 0;
+        short fish_number = FISH_START_NUMBER;
+        char fish_type = FISH_TYPE_NORMAL;
+
+        GameSim(bn::random& random, int width, int height, const CollisionGrid& grid) :
+            fish_context(create_fish_context(random, width, height, grid)),
+            fish(this->fish_context),
+            player(0, 0, grid, random) {
+            for(char i = 0; i < this->fish_number; i++) {
+                createFish(this->fish, this->fish_context, this->fish_type);
+            }
+        }
+        bool over() const {
+            return(this->player.getLife() == 0);
+        }
+        // (view_x, view_y) : center of the view, fish out of it are updated less often
+        void step(unsigned input, bn::fixed view_x, bn::fixed view_y) {
+            FishSim<Capacity>& fish_pool = this->fish;
+            PlayerCore& pj = this->player;
+
+            fish_pool.setThreat(pj.x(), pj.y());
+            fish_pool.update(view_x, view_y);
+            if(pj.getState() == PJ_STATE_EATING) {
+                // Only the fish around the piranha's mouth
+                fish_pool.query(pj.x(), pj.y(), FISH_BOXSIZE, [&](int fish_index) {
+                    if(fish_pool.getState(fish_index) == FISH_STATE_NORMAL && fish_pool.collision(fish_index, pj.x(), pj.y())) {
+                        // Quand on avale un poisson
+                        const FishDescriptor& descriptor = fish_descriptors[fish_pool.getType(fish_index)];
+                        pj.setFX(descriptor.effect);
+                        if(descriptor.life_delta > 0) pj.heal(descriptor.life_delta);
+                        if(descriptor.life_delta < 0) pj.hurt(-descriptor.life_delta);
+                        pj.eat();
+                        this->fish_points+=1;
+                        fish_pool.kill(fish_index);
+                    }
+                    return(true);
+                });
+            }
+            for(int fish_index = 0; fish_index < fish_pool.capacity(); fish_index++) {
+                if(!fish_pool.active(fish_index)) continue;
+                if(fish_pool.getState(fish_index) == FISH_STATE_DEAD) {
+                    // The slot is recycled by the next fish
+                    fish_pool.release(fish_index);
+                    createFish(fish_pool, this->fish_context, this->fish_type);
+
+                    if(this->fish_points % 10 == 0) {
+                        if(this->fish_type < FISH_TYPE_DEFORMATION) this->fish_type++;
+                    }
+                    if(this->fish_points % 5 == 0) {
+                        if(this->fish_number < FISH_GAME_MAX_NUMBER) this->fish_number++;
+                        if(fish_pool.size() < this->fish_number)
+                        {
+                            if (this->fish_number < FISH_DEATH_THRESHOLD) createFish(fish_pool, this->fish_context, this->fish_type);
+                            else createDeathFish(fish_pool, this->fish_context);
+                        }
+                    }
+                }
+            }
+
+            // Passage en mode eat
+            if((input & PJ_INPUT_EAT) && pj.getState() == PJ_STATE_STANDING) {
+                pj.setStateEat();
+            }
+
+            pj.update(input);
+        }
+};
+
+#endif
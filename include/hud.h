@@ -0,0 +1,62 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef HUD_H
+#define HUD_H
+
+#include "bn_optional.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_tiles_ptr.h"
+
+#include "world.h"
+#include "profiler.h"
+#include "text_layer.h"
+
+/*
+    In-game HUD : lifebar and score counter
+    Nothing is written while the values don't change. Tiles of the 9 lifebar states are
+    created once, a change only points the lifebar to other tiles. The score is a line
+    of the text layer : no sprite nor VRAM allocation during the game.
+*/
+#define HUD_LIFE_STATES     9
+#define HUD_SCORE_LINE      0
+#define HUD_SCORE_X         (GBA_SCREEN_WIDTH/2-16)
+#define HUD_SCORE_Y         (GBA_SCREEN_HEIGHT/2-8)
+
+class Hud {
+    private:
+        TextLayer* text_layer;
+        bn::sprite_ptr lifebar;
+        bn::sprite_ptr counter;
+        bn::optional<bn::sprite_tiles_ptr> lifebar_tiles[HUD_LIFE_STATES];
+        int life = -1;
+        int score = -1;
+
+    public:
+        Hud(TextLayer& layer);
+        void setLife(int value);
+        void setScore(int value);
+};
+
+#if PROFILER_ENABLED
+/*
+    Profiler overlay, toggled with Select
+    One text line per section (mean cycles and a bar, one '#' per 2% of the frame) and
+    the CPU usage of the last frame. Refreshed every 16 frames.
+*/
+#define PROFILER_FIRST_LINE     1
+#define PROFILER_BAR_PERCENT    2
+
+void profiler_overlay(TextLayer& text_layer, bool& visible);
+#endif
+
+// Text layer lines of the game : the score, and the profiler overlay when built
+#if PROFILER_ENABLED
+    #define HUD_TEXT_LINES      (PROFILER_FIRST_LINE + PROFILER_SECTIONS + 1)
+#else
+    #define HUD_TEXT_LINES      (HUD_SCORE_LINE + 1)
+#endif
+
+#endif
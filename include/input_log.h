@@ -0,0 +1,91 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#define INPUT_LOG_RUN_MAX 255   // Frames of a run, at most
+
+/*
+    One run of an input log : the same input bitmask for count frames
+*/
+struct InputRun {
+    unsigned char input;
+    unsigned char count;
+};
+
+/*
+    Run-length encoded input of a game, one PJ_INPUT_* bitmask per frame, stored in a
+    buffer given by the owner. The input rarely changes from one frame to the next :
+    a minute of play usually fits in a few hundred runs.
+*/
+class InputLog {
+    private:
+        InputRun* runs;
+        int capacity;
+        int count;
+        int read_run;
+        int read_frame;
+
+    public:
+        InputLog(InputRun* buffer, int buffer_capacity) {
+            this->runs = buffer;
+            this->capacity = buffer_capacity;
+            this->clear();
+        }
+        int size() const {
+            return(this->count);
+        }
+        const InputRun* data() const {
+            return(this->runs);
+        }
+        InputRun* data() {
+            return(this->runs);
+        }
+        void clear() {
+            this->count = 0;
+            this->rewind();
+        }
+        // The first run_count runs of the buffer have been filled by the owner
+        void setSize(int run_count) {
+            this->count = run_count;
+            this->rewind();
+        }
+        // Returns false when the log is full : the frame is lost
+        bool record(unsigned input) {
+            if(this->count > 0) {
+                InputRun& last = this->runs[this->count - 1];
+                if(last.input == input && last.count < INPUT_LOG_RUN_MAX) {
+                    last.count += 1;
+                    return(true);
+                }
+            }
+            if(this->count == this->capacity) return(false);
+            this->runs[this->count].input = input;
+            this->runs[this->count].count = 1;
+            this->count += 1;
+            return(true);
+        }
+        void rewind() {
+            this->read_run = 0;
+            this->read_frame = 0;
+        }
+        bool finished() const {
+            return(this->read_run >= this->count);
+        }
+        // Input of the next frame, 0 once every run has been played
+        unsigned play() {
+            if(this->finished()) return(0);
+            const InputRun& run = this->runs[this->read_run];
+            this->read_frame += 1;
+            if(this->read_frame == run.count) {
+                this->read_run += 1;
+                this->read_frame = 0;
+            }
+            return(run.input);
+        }
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#include "bn_random.h"
+
+#include "input_log.h"
+
+#define INPUT_MODE_RECORD       0   // Keypad input, each game is saved to SRAM
+#define INPUT_MODE_PLAYBACK     1   // Input of the game saved in SRAM, replayed by every game
+#define INPUT_MODE_SCRIPT       2   // Scripted input, nothing saved (benchmark ROM)
+
+#define INPUT_SCRIPT_PERIOD     24  // Frames between two scripted direction changes
+
+#define INPUT_REPLAY_MAGIC      0x31435250  // "PRC1"
+#define INPUT_REPLAY_CHUNK_RUNS 256         // Runs copied to / from SRAM at once
+#define INPUT_REPLAY_CHUNKS     63          // 63 * 512 bytes of runs, after the header
+
+/*
+    Source of the input of game() : the keypad, recorded with the seed of the game
+    random generator, or a replay of the last recorded game. GameSim only depends on its
+    seed and its input, so a replayed game is the same game, frame for frame.
+    The recording is kept in EWRAM and only written to SRAM when the game ends.
+    The scripted input swims around and opens the mouth, always the same way.
+*/
+class InputReplay {
+    private:
+        InputLog log;
+        char mode;
+        unsigned seed;
+        int recorded_score;
+        bool truncated;
+        bn::random script_random;
+        int script_frame;
+        unsigned script_input;
+
+        unsigned script();
+
+        bool load();
+        void save(int score);
+
+    public:
+        // Falls back to INPUT_MODE_RECORD when SRAM holds no recording
+        InputReplay(char input_mode);
+
+        // The scenes go on without waiting for start
+        bool playback() const {
+            return(this->mode != INPUT_MODE_RECORD);
+        }
+        // Start of a game, returns the seed of its random generator (record_seed when recording)
+        unsigned begin(unsigned record_seed);
+        // Input bitmask (PJ_INPUT_*) of the frame
+        unsigned read();
+        // End of a game : saves the recording, or checks the replayed score
+        void end(int score);
+};
+
+#endif
@@ -0,0 +1,175 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef PLAYER_CORE_H
+#define PLAYER_CORE_H
+
+#include "bn_fixed.h"
+#include "bn_random.h"
+#include "collision.h"
+
+/*
+    State flags for the player
+    0x00 = standing
+    0x01 = eating
+*/
+#define PJ_STATE_STANDING   0
+#define PJ_STATE_EATING     1
+#define PJ_STATE_SWALLOWING 2
+#define PJ_STATE_COUNT      3
+#define PJ_INVINCIBLE_DELAY 30
+#define PJ_EATING_ANIMATION_DELAY 100
+#define PJ_SWALLOW_ANIMATION_DELAY 50
+#define PJ_HITBOX_HALF_SIZE 4
+#define PJ_LIFE_MAX 8
+#define PJ_LIFE_DRAIN_FRAMES 300    // Frames to lose a life unit : 0.2 life per second
+#define BG_CONFUSION_RATE 30 //30 = 0.5 sec
+
+#define PJ_FX_NORMAL    0
+#define PJ_FX_SPEED     1
+#define PJ_FX_CONFUS    2
+#define PJ_FX_DEFORM    3
+#define PJ_FX_COUNT     4
+
+/*
+    Acceleration of an effect and the speed limit of each state (acceleration * 50 when
+    standing, * 80 when eating, * 20 when swallowing), computed at compile time.
+    The reciprocals (2^24 / maxspeed data) turn the impact volume into a multiplication :
+    the GBA has no hardware divider.
+*/
+#define PJ_RECIPROCAL_SHIFT 24
+
+struct PlayerLimits {
+    bn::fixed acceleration;
+    bn::fixed maxspeed[PJ_STATE_COUNT];
+    int maxspeed_reciprocal[PJ_STATE_COUNT];
+};
+
+/*
+    Input of a frame, as a bitmask (filled from the keypad on the GBA)
+*/
+#define PJ_INPUT_LEFT       0x01
+#define PJ_INPUT_RIGHT      0x02
+#define PJ_INPUT_UP         0x04
+#define PJ_INPUT_DOWN       0x08
+#define PJ_INPUT_EAT        0x10    // A pressed this frame
+
+/*
+    Events raised by the simulation for the presentation (sprite, sounds, camera)
+*/
+#define PJ_EVENT_STATE      0x01    // State changed : new animation
+#define PJ_EVENT_EAT        0x02    // A fish has been eaten
+#define PJ_EVENT_GRUNT      0x04    // Mouth opened
+#define PJ_EVENT_HURT       0x08    // Spikes or death fish : rumble
+#define PJ_EVENT_BOUNCE     0x10    // Wall bounce while not eating
+#define PJ_EVENT_CHOC       0x20    // Wall bounce while eating : rumble, volume in impact()
+#define PJ_EVENT_BACKGROUND 0x40    // Background stretch or alpha changed
+#define PJ_EVENT_FLIP       0x80    // Facing side changed
+
+/*
+    Piranha simulation : physics, life and effects, without any sprite.
+    update() takes the input bitmask of the frame, the presentation reads the events
+    raised since its last takeEvents().
+*/
+class PlayerCore {
+    private:
+        const CollisionGrid* grid;
+        bn::random* random;
+        bn::fixed pos_x;
+        bn::fixed pos_y;
+        bn::fixed speed_x;
+        bn::fixed speed_y;
+        const PlayerLimits* limits;
+        bn::fixed acceleration;
+        bn::fixed maxspeed;             // Taken from the limits when the state changes
+        int maxspeed_reciprocal;
+        char state;
+        short eating_timer;
+        short swallowing_timer;
+        bool eaten;
+        short life;
+        short life_timer;               // Frames since life was last a whole number
+        bool is_hurt = false;
+        short hurt_timer;
+        char effect;
+        unsigned char confus_timer;
+        bool facing_left;
+        bn::fixed bg_stretch;
+        bn::fixed bg_alpha;
+        bn::fixed impact_volume;
+        unsigned events;
+
+        void set_background(bn::fixed stretch, bn::fixed alpha);
+        void set_normal_background() {
+            this->set_background(0, 1);
+        }
+        void setLimits(int fx);
+        void setMaxspeed();
+        void bounce(bn::fixed speed);
+
+    public:
+        PlayerCore(bn::fixed x, bn::fixed y, const CollisionGrid& collision_grid, bn::random& rand);
+
+        bn::fixed x() const {
+            return(this->pos_x);
+        }
+        bn::fixed y() const {
+            return(this->pos_y);
+        }
+        bn::fixed getSpeedX() const {
+            return(this->speed_x);
+        }
+        bn::fixed getSpeedY() const {
+            return(this->speed_y);
+        }
+        char getState() const {
+            return(this->state);
+        }
+        char getFX() const {
+            return(this->effect);
+        }
+        // Rounded, as the life drains continuously
+        short getLife() const {
+            return(this->life_timer > PJ_LIFE_DRAIN_FRAMES / 2 ? this->life - 1 : this->life);
+        }
+        bool facingLeft() const {
+            return(this->facing_left);
+        }
+        bn::fixed backgroundStretch() const {
+            return(this->bg_stretch);
+        }
+        bn::fixed backgroundAlpha() const {
+            return(this->bg_alpha);
+        }
+        // Volume of the last PJ_EVENT_CHOC, in [0, 1]
+        bn::fixed impact() const {
+            return(this->impact_volume);
+        }
+        // Returns the PJ_EVENT_* raised since the last call
+        unsigned takeEvents() {
+            unsigned result = this->events;
+            this->events = 0;
+            return(result);
+        }
+
+        void setFullLife() {
+            this->life = PJ_LIFE_MAX;
+            this->life_timer = 0;
+        }
+        void heal(short amount);
+        void eat();
+        void hurt(short hurt = 1);
+        void setFX(char fx);
+        void setFXNormal();
+        void setFXSpeed();
+        void setFXConfused();
+        void setFXDeformation();
+        void setStateSwallowing();
+        void setStateStand();
+        void setStateEat();
+        void update(unsigned input);
+};
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef PLAYER_VIEW_H
+#define PLAYER_VIEW_H
+
+#include "bn_optional.h"
+#include "bn_camera_ptr.h"
+#include "bn_sprite_ptr.h"
+#include "bn_sprite_animate_actions.h"
+
+#include "player_core.h"
+#include "sound_events.h"
+#include "camera_controller.h"
+
+#define PJ_ANIMATION_STAND  0
+#define PJ_ANIMATION_EAT    1
+
+/*
+    Sprite, sounds and camera shakes of the piranha, driven by the PlayerCore events
+*/
+class PlayerView {
+    private :
+        bn::sprite_ptr sprite;
+        bn::optional<bn::sprite_animate_action<4>> animation;
+        CameraController* camera_controller;
+        SoundEvents* sounds;
+
+        void setAnimation(char state);
+
+    public :
+        // The sprite is attached to cam, moved by camera_control
+        PlayerView(const PlayerCore& core, bn::camera_ptr& cam, CameraController& camera_control, SoundEvents& sound_events);
+        void update(PlayerCore& core);
+};
+
+#endif
@@ -0,0 +1,93 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*
+    Frame profiler
+    Build with USERFLAGS := -DPROFILER_ENABLED=1 to measure the game loop sections.
+    Disabled, the PROFILER_* macros compile to nothing.
+*/
+#ifndef PROFILER_ENABLED
+    #define PROFILER_ENABLED 0
+#endif
+
+#define GBA_CYCLES_PER_FRAME    280896
+
+#define PROFILER_FISH           0
+#define PROFILER_PLAYER         1
+#define PROFILER_BACKDROP       2
+#define PROFILER_HUD            3
+#define PROFILER_CAMERA         4
+#define PROFILER_SECTIONS       5
+#define PROFILER_HISTORY        32      // Frames kept in the ring buffer (must be a power of 2)
+
+#if PROFILER_ENABLED
+
+#include "bn_timer.h"
+#include "bn_timers.h"
+
+constexpr const char* profiler_names[PROFILER_SECTIONS] = {
+    "fish", "player", "backdrop", "hud", "camera"
+};
+
+/*
+    Cycles spent in each section, for the last PROFILER_HISTORY frames.
+    A section can be entered several times in a frame, its cycles are added.
+*/
+class Profiler {
+    private:
+        bn::timer timer;
+        int start[PROFILER_SECTIONS] = {};
+        int current[PROFILER_SECTIONS] = {};
+        int history[PROFILER_HISTORY][PROFILER_SECTIONS] = {};
+        int frame = 0;
+
+    public:
+        void begin(int section) {
+            this->start[section] = this->timer.elapsed_ticks();
+        }
+        void end(int section) {
+            this->current[section] += this->timer.elapsed_ticks() - this->start[section];
+        }
+        void endFrame() {
+            int cycles_per_tick = GBA_CYCLES_PER_FRAME / bn::timers::ticks_per_frame();
+            int* frame_cycles = this->history[this->frame & (PROFILER_HISTORY - 1)];
+            for(int section = 0; section < PROFILER_SECTIONS; section++) {
+                frame_cycles[section] = this->current[section] * cycles_per_tick;
+                this->current[section] = 0;
+            }
+            this->frame += 1;
+            this->timer.restart();
+        }
+        int frames() const {
+            return(this->frame);
+        }
+        // Mean cycles per frame of a section over the ring buffer
+        int average(int section) const {
+            int total = 0;
+            for(int index = 0; index < PROFILER_HISTORY; index++) {
+                total += this->history[index][section];
+            }
+            return(total / PROFILER_HISTORY);
+        }
+};
+
+extern Profiler profiler;
+
+#define PROFILER_BEGIN(section) profiler.begin(section)
+#define PROFILER_END(section)   profiler.end(section)
+#define PROFILER_FRAME()        profiler.endFrame()
+
+#else
+
+#define PROFILER_BEGIN(section) ((void)0)
+#define PROFILER_END(section)   ((void)0)
+#define PROFILER_FRAME()        ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef SCENE_LOADER_H
+#define SCENE_LOADER_H
+
+#include "bn_timer.h"
+#include "bn_timers.h"
+
+#define SCENE_STAGE_NEXT            0   // Stage done, the next one may run in the same frame
+#define SCENE_STAGE_VBLANK          1   // Stage done with a VRAM upload : the next one waits for the next frame
+#define SCENE_STAGE_DONE            2   // No stage left
+#define SCENE_LOAD_BUDGET_PERCENT   25  // Part of a frame given to the loading stages
+
+/*
+    Staged loading of the assets of a scene
+    Assets::loadStage(stage) creates one piece of the scene (a map, a set of tiles...) and
+    returns a SCENE_STAGE_* value. The running scene calls update() once per frame : stages
+    run until the cycle budget is spent or a stage has something to upload in the vblank,
+    so the next scene starts with its assets ready and no long frame.
+    finish() runs the stages left at once, when the next scene can't wait anymore.
+*/
+template<class Assets>
+class SceneLoader {
+    private:
+        Assets* assets;
+        int stage;
+        bool done;
+
+        // Returns true when the next stage may run in the same frame
+        bool runStage() {
+            int result = this->assets->loadStage(this->stage);
+            if(result == SCENE_STAGE_DONE) {
+                this->done = true;
+                return(false);
+            }
+            this->stage += 1;
+            return(result == SCENE_STAGE_NEXT);
+        }
+
+    public:
+        SceneLoader(Assets& scene_assets) {
+            this->assets = &scene_assets;
+            this->restart();
+        }
+        bool ready() const {
+            return(this->done);
+        }
+        // The assets have been released, they are loaded again from the first stage
+        void restart() {
+            this->stage = 0;
+            this->done = false;
+        }
+        void update() {
+            bn::timer timer;
+            int budget = bn::timers::ticks_per_frame() * SCENE_LOAD_BUDGET_PERCENT / 100;
+            while(!this->done && this->runStage() && timer.elapsed_ticks() < budget) {
+            }
+        }
+        void finish() {
+            while(!this->done) {
+                this->runStage();
+            }
+        }
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef SCENES_H
+#define SCENES_H
+
+#include "bn_optional.h"
+#include "bn_sprite_tiles_ptr.h"
+#include "bn_sprite_palette_ptr.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+
+#include "backdrop.h"
+#include "fish_view.h"
+#include "input_replay.h"
+#include "scene_loader.h"
+
+/*
+    Assets of game(), preloaded by the title screen with a SceneLoader
+    The level tiles and the sprite tiles are uploaded while the title runs : game() builds
+    its background and sprites from them without any big VRAM upload, the level map is
+    streamed from ROM (StreamedLevel).
+*/
+class GameAssets {
+    public:
+        bn::optional<bn::regular_bg_tiles_ptr> lvl0_tiles;
+        bn::optional<bn::bg_palette_ptr> lvl0_palette;
+        bn::optional<FishAnimation> fish_animation;
+        bn::optional<bn::sprite_tiles_ptr> pj_tiles;
+        bn::optional<bn::sprite_palette_ptr> pj_palette;
+
+        int loadStage(int stage);
+        void clear();
+};
+
+// seed : seed of the random generator when recording (see InputReplay::begin())
+int game(OceanBackdrop& backdrop, InputReplay& input, unsigned seed, GameAssets& assets);
+// Returns the number of frames spent on the screen, autostart : no need to press start
+int title(OceanBackdrop& backdrop, bool autostart, SceneLoader<GameAssets>& game_loader);
+// autostart : leaves the screen after RESULTS_AUTOSTART_DELAY frames
+int results(int score, OceanBackdrop& backdrop, bool autostart);
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef SOUND_EVENTS_H
+#define SOUND_EVENTS_H
+
+#include "bn_fixed.h"
+#include "bn_optional.h"
+#include "bn_sound_handle.h"
+
+#define SOUND_GRUNT     0
+#define SOUND_EAT       1
+#define SOUND_SPIKE     2
+#define SOUND_CHOC      3
+#define SOUND_BOING     4
+#define SOUND_COUNT     5
+
+#define SOUND_VOICE_MAX 3   // Sound effects mixed at once, at most
+#define SOUND_PRIORITY_MAX 4    // Highest priority of an effect
+
+/*
+    Sound effects of the game, played through a fixed number of voices
+    request() only notes an effect : the requests of a frame are coalesced (one per effect,
+    at the loudest volume) and played by update(). An effect requested again before its
+    cooldown is over is dropped, and when every voice is used, a new effect only takes
+    the voice of a lower priority one. The mixing cost never exceeds SOUND_VOICE_MAX
+    sounds, whatever happens in a frame.
+*/
+class SoundEvents {
+    private:
+        struct Voice {
+            bn::optional<bn::sound_handle> handle;
+            unsigned char effect;
+        };
+
+        Voice voices[SOUND_VOICE_MAX];
+        bn::fixed requested[SOUND_COUNT];       // Volume requested this frame, 0 : none
+        unsigned char cooldown[SOUND_COUNT];    // Frames before the effect can be played again
+
+        int freeVoice();
+        void play(int effect);
+
+    public:
+        SoundEvents();
+
+        void request(int effect, bn::fixed volume = 1);
+        // Plays the requests of the frame, once per frame
+        void update();
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "bn_assert.h"
+#include "bn_fixed.h"
+
+#define SPATIAL_GRID_CELL_SHIFT 5       // 32px cells
+#define SPATIAL_GRID_CELL_SIZE  (1 << SPATIAL_GRID_CELL_SHIFT)
+#define SPATIAL_GRID_NONE       255
+
+/*
+    Uniform grid over a level centered on (0, 0)
+    Each cell holds an intrusive doubly linked list of object indexes : inserting,
+    removing and moving an object are O(1), and move() only relinks it when it changes
+    of cell. query() visits every object of the cells overlapping a square, callers
+    do the exact distance test.
+*/
+template<int Capacity, int MaxCells>
+class SpatialGrid {
+    private:
+        unsigned char head[MaxCells];
+        unsigned char next[Capacity];
+        unsigned char previous[Capacity];
+        unsigned short cell[Capacity];
+        int origin_x;
+        int origin_y;
+        int grid_columns;
+        int grid_rows;
+
+        static_assert(Capacity < SPATIAL_GRID_NONE, "Invalid spatial grid capacity");
+
+        int column(int x) const {
+            int value = (x - this->origin_x) >> SPATIAL_GRID_CELL_SHIFT;
+            if(value < 0) return(0);
+            if(value >= this->grid_columns) return(this->grid_columns - 1);
+            return(value);
+        }
+        int row(int y) const {
+            int value = (y - this->origin_y) >> SPATIAL_GRID_CELL_SHIFT;
+            if(value < 0) return(0);
+            if(value >= this->grid_rows) return(this->grid_rows - 1);
+            return(value);
+        }
+        int cellAt(bn::fixed x, bn::fixed y) const {
+            return(this->row(y.integer()) * this->grid_columns + this->column(x.integer()));
+        }
+        void link(int index, int cell_index) {
+            this->cell[index] = cell_index;
+            this->previous[index] = SPATIAL_GRID_NONE;
+            this->next[index] = this->head[cell_index];
+            if(this->head[cell_index] != SPATIAL_GRID_NONE) this->previous[this->head[cell_index]] = index;
+            this->head[cell_index] = index;
+        }
+        void unlink(int index) {
+            if(this->previous[index] != SPATIAL_GRID_NONE) this->next[this->previous[index]] = this->next[index];
+            else this->head[this->cell[index]] = this->next[index];
+            if(this->next[index] != SPATIAL_GRID_NONE) this->previous[this->next[index]] = this->previous[index];
+        }
+
+    public:
+        SpatialGrid(int width, int height) {
+            this->origin_x = -width / 2;
+            this->origin_y = -height / 2;
+            this->grid_columns = (width + SPATIAL_GRID_CELL_SIZE - 1) >> SPATIAL_GRID_CELL_SHIFT;
+            this->grid_rows = (height + SPATIAL_GRID_CELL_SIZE - 1) >> SPATIAL_GRID_CELL_SHIFT;
+            BN_ASSERT(this->grid_columns * this->grid_rows <= MaxCells, "Level too big for the spatial grid");
+            for(int cell_index = 0; cell_index < MaxCells; cell_index++) {
+                this->head[cell_index] = SPATIAL_GRID_NONE;
+            }
+        }
+        void insert(int index, bn::fixed x, bn::fixed y) {
+            this->link(index, this->cellAt(x, y));
+        }
+        void remove(int index) {
+            this->unlink(index);
+        }
+        void move(int index, bn::fixed x, bn::fixed y) {
+            int cell_index = this->cellAt(x, y);
+            if(cell_index == this->cell[index]) return;
+            this->unlink(index);
+            this->link(index, cell_index);
+        }
+        // visitor(index) returns false to stop the query
+        template<class Visitor>
+        void query(bn::fixed x, bn::fixed y, int radius, Visitor&& visitor) const {
+            int first_column = this->column(x.integer() - radius);
+            int last_column = this->column(x.integer() + radius);
+            int first_row = this->row(y.integer() - radius);
+            int last_row = this->row(y.integer() + radius);
+            for(int row_index = first_row; row_index <= last_row; row_index++) {
+                for(int column_index = first_column; column_index <= last_column; column_index++) {
+                    int index = this->head[row_index * this->grid_columns + column_index];
+                    while(index != SPATIAL_GRID_NONE) {
+                        int next_index = this->next[index];
+                        if(!visitor(index)) return;
+                        index = next_index;
+                    }
+                }
+            }
+        }
+};
+
+#endif
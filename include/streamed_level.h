@@ -0,0 +1,72 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef STREAMED_LEVEL_H
+#define STREAMED_LEVEL_H
+
+#include "bn_fixed.h"
+#include "bn_camera_ptr.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_regular_bg_item.h"
+#include "bn_regular_bg_map_item.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+
+#define LEVEL_RING_COLUMNS  64  // VRAM map : 64x32 cells (512x256 px), whatever the level size
+#define LEVEL_RING_ROWS     32
+#define LEVEL_MARGIN_CELLS  2   // Cells loaded around the screen, ahead of the scrolling
+
+/*
+    Level background streamed from ROM
+    The level map stays in ROM, VRAM only holds a 64x32 cells ring map : level cell (c, r)
+    is always written to ring cell (c % 64, r % 32), so the hardware wrap of the map shows
+    the right cells once the background is placed on the level origin. When the camera
+    moves, only the newly exposed columns and rows are written to VRAM : VRAM use and
+    load time no longer depend on the level size.
+    The level map must not be compressed. Its cells are read with map_item.cell() : maps
+    that are not big are stored by screen blocks in ROM, not row by row. Its tiles and
+    palette are given by the scene (loaded with the other assets of the game).
+*/
+class StreamedLevel {
+    private:
+        bn::regular_bg_map_item map_item;       // Level map in ROM
+        int columns;
+        int rows;
+        bn::regular_bg_map_ptr map;
+        bn::regular_bg_ptr bg;
+        int first_column;                       // Level cells held by the ring map
+        int first_row;
+
+        // Level cell pointing to the level tiles and palette, moved by the allocation
+        bn::regular_bg_map_cell levelCell(int column, int row) const;
+        void writeCell(bn::regular_bg_map_cell* vram, int column, int row);
+        void writeColumn(bn::regular_bg_map_cell* vram, int column);
+        void writeRow(bn::regular_bg_map_cell* vram, int row);
+        // First level column or row of the screen and its margin, for a camera position
+        int viewColumn(bn::fixed camera_x) const;
+        int viewRow(bn::fixed camera_y) const;
+
+    public:
+        StreamedLevel(const bn::regular_bg_item& item, const bn::regular_bg_tiles_ptr& tiles, const bn::bg_palette_ptr& palette,
+                      bn::camera_ptr& camera);
+
+        bn::regular_bg_ptr& background() {
+            return(this->bg);
+        }
+        // Level size in pixels
+        int width() const {
+            return(this->columns * 8);
+        }
+        int height() const {
+            return(this->rows * 8);
+        }
+        // Writes the cells exposed by the camera, once per frame after the camera moves
+        void update(bn::fixed camera_x, bn::fixed camera_y);
+        // true if every ring cell in VRAM holds its level cell, checked by the benchmark ROM
+        bool check();
+};
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef TEXT_LAYER_H
+#define TEXT_LAYER_H
+
+#include "bn_string_view.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_regular_bg_map_ptr.h"
+#include "bn_regular_bg_tiles_ptr.h"
+
+/*
+    Text drawn on a regular background instead of sprites
+    The glyphs of the variable 8x16 sprite font are composed, with their own widths, in
+    the tiles of a text line : each line owns TEXT_LAYER_LINE_TILES tiles (30x2 cells)
+    and is placed on a map row of a 32x32 map fixed on the screen. A layer only allocates
+    the lines its screen uses.
+    A new text is only composed from its first glyph that differs from the previous text
+    of the line (when it starts at the same place), and only the tiles that differ are
+    copied to VRAM. Map cells are only written when a line moves, appears or disappears.
+    Lines must not share map rows.
+*/
+#define TEXT_LAYER_LINES_MAX    8
+#define TEXT_LAYER_TEXT_MAX     48
+#define TEXT_LAYER_COLUMNS      30
+#define TEXT_LAYER_MAP_SIZE     32
+#define TEXT_LAYER_LINE_TILES   (TEXT_LAYER_COLUMNS * 2)
+
+class TextLayer {
+    private:
+        int lines;
+        bn::regular_bg_tiles_ptr tiles;
+        bn::regular_bg_map_ptr map;
+        bn::regular_bg_ptr bg;
+        signed char line_row[TEXT_LAYER_LINES_MAX];     // -1 : not placed
+        bool line_visible[TEXT_LAYER_LINES_MAX];
+        // Text in the tiles of each line, its first pixel and the column after its last one
+        char line_text[TEXT_LAYER_LINES_MAX][TEXT_LAYER_TEXT_MAX];
+        unsigned char line_length[TEXT_LAYER_LINES_MAX];
+        short line_pen[TEXT_LAYER_LINES_MAX];
+        signed char line_end[TEXT_LAYER_LINES_MAX];
+
+        // Tile 0 is blank, line tiles follow
+        void writeCells(int line, bool show);
+
+    public:
+        // Screen top left corner on the map top left corner, lines : TEXT_LAYER_LINES_MAX at most
+        TextLayer(int lines);
+        // Centered on (x, y), like the sprite text generator. y - 8 must be a multiple of 8.
+        void print(int line, int x, int y, const bn::string_view& text);
+        void setVisible(int line, bool visible);
+        void clear(int line);
+};
+
+#endif
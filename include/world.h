@@ -0,0 +1,21 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#define GBA_SCREEN_WIDTH 240
+#define GBA_SCREEN_HEIGHT 160
+
+/* 
+    To reduce the display of the background if necessary (areas to be hidden)
+    Good for hide collision tiles that are put in the upper left corner
+*/
+#define CAM_OFFSET_LEFT_LIMIT 16
+#define CAM_OFFSET_RIGHT_LIMIT 16
+#define CAM_OFFSET_UP_LIMIT 16
+#define CAM_OFFSET_DOWN_LIMIT 16
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "backdrop.h"
+
+#include "bn_display.h"
+#include "bn_window.h"
+#include "bn_affine_bg_items_bg_soft.h"
+
+BN_DATA_EWRAM OceanWobble ocean_wobble;
+
+OceanBackdrop::OceanBackdrop() {
+    this->bg = bn::affine_bg_items::bg_soft.create_bg(0, 0);
+
+    this->internal_window = bn::rect_window::internal();
+    this->internal_window->set_top_left(-(bn::display::height() / 2), -1000);
+    this->internal_window->set_bottom_right((bn::display::height() / 2), 1000);
+    bn::window::outside().set_show_bg(*this->bg, false);
+
+    ocean_wobble.init(this->bg->mat_attributes());
+    this->frame = 0;
+    this->attributes_hbe = bn::affine_bg_mat_attributes_hbe_ptr::create(*this->bg, ocean_wobble.slice(this->frame));
+}
@@ -0,0 +1,84 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "bench.h"
+
+#if BENCH_ENABLED
+
+#include "bn_common.h"
+#include "bn_core.h"
+#include "bn_log.h"
+
+/*
+    Frames of a run of the same scene, from start to the next run
+*/
+struct BenchRun {
+    const char* scene;
+    int start;
+};
+
+struct BenchCheck {
+    const char* name;
+    bool ok;
+};
+
+BN_DATA_EWRAM short bench_samples[BENCH_SAMPLES_MAX];
+BN_DATA_EWRAM BenchRun bench_runs[BENCH_RUNS_MAX];
+BN_DATA_EWRAM BenchCheck bench_checks[BENCH_CHECKS_MAX];
+static int bench_sample_count = 0;
+static int bench_run_count = 0;
+static int bench_check_count = 0;
+static bool bench_overflow = false;
+
+void bench_frame(const char* scene) {
+    if(bench_sample_count == BENCH_SAMPLES_MAX) {
+        bench_overflow = true;
+        return;
+    }
+    if(bench_run_count == 0 || bench_runs[bench_run_count - 1].scene != scene) {
+        if(bench_run_count == BENCH_RUNS_MAX) {
+            bench_overflow = true;
+            return;
+        }
+        bench_runs[bench_run_count].scene = scene;
+        bench_runs[bench_run_count].start = bench_sample_count;
+        bench_run_count += 1;
+    }
+    bench_samples[bench_sample_count] = short(bn::core::last_cpu_usage().data());
+    bench_sample_count += 1;
+}
+
+void bench_check(const char* name, bool ok) {
+    if(bench_check_count == BENCH_CHECKS_MAX) {
+        bench_overflow = true;
+        return;
+    }
+    bench_checks[bench_check_count].name = name;
+    bench_checks[bench_check_count].ok = ok;
+    bench_check_count += 1;
+}
+
+// Ends the emulator run, r0 is the exit code
+[[noreturn]] void bench_exit() {
+    for(int run = 0; run < bench_run_count; run++) {
+        int end = run + 1 < bench_run_count ? bench_runs[run + 1].start : bench_sample_count;
+        for(int sample = bench_runs[run].start; sample < end; sample++) {
+            BN_LOG("BENCH ", bench_runs[run].scene, " ", bench_samples[sample]);
+        }
+    }
+    for(int check = 0; check < bench_check_count; check++) {
+        BN_LOG("BENCH check ", bench_checks[check].name, bench_checks[check].ok ? " ok" : " failed");
+    }
+    // Frames or checks dropped : the run is incomplete
+    BN_LOG("BENCH check buffers", bench_overflow ? " failed" : " ok");
+    BN_LOG("BENCH end");
+    register int exit_code asm("r0") = 0;
+    asm volatile("swi %1" :: "r"(exit_code), "i"(BENCH_EXIT_SWI) : "r1", "r2", "r3", "memory");
+    while(true) {
+        bn::core::update();
+    }
+}
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "camera_controller.h"
+
+#include "bn_algorithm.h"
+
+#include "world.h"
+
+// Offset of the level background on each shake frame, back to 0 on the last one
+constexpr signed char camera_shake_offsets[CAMERA_SHAKE_FRAMES] = {
+    -CAMERA_SHAKE_AMPLITUDE, 0, CAMERA_SHAKE_AMPLITUDE, 0,
+    -CAMERA_SHAKE_AMPLITUDE, 0, CAMERA_SHAKE_AMPLITUDE, 0,
+    -CAMERA_SHAKE_AMPLITUDE, 0, CAMERA_SHAKE_AMPLITUDE, 0,
+    -CAMERA_SHAKE_AMPLITUDE, 0, CAMERA_SHAKE_AMPLITUDE, 0,
+};
+
+CameraController::CameraController(bn::camera_ptr& cam, bn::regular_bg_ptr& level_bg, int level_width, int level_height,
+                                   bn::fixed target_x, bn::fixed target_y) {
+    this->camera = &cam;
+    this->shake_bg = &level_bg;
+    this->shake_x = level_bg.x();
+    this->shake_y = level_bg.y();
+    this->shake_index = CAMERA_SHAKE_FRAMES;
+
+    // The view stays in the level, without its hidden borders (CAM_OFFSET_*_LIMIT)
+    int width = level_width;
+    int height = level_height;
+    this->min_x = GBA_SCREEN_WIDTH/2 - width/2 + CAM_OFFSET_LEFT_LIMIT;
+    this->max_x = width/2 - GBA_SCREEN_WIDTH/2 - CAM_OFFSET_RIGHT_LIMIT;
+    this->min_y = GBA_SCREEN_HEIGHT/2 - height/2 + CAM_OFFSET_UP_LIMIT;
+    this->max_y = height/2 - GBA_SCREEN_HEIGHT/2 - CAM_OFFSET_DOWN_LIMIT;
+
+    this->x = bn::clamp(target_x, this->min_x, this->max_x);
+    this->y = bn::clamp(target_y, this->min_y, this->max_y);
+    this->camera->set_position(this->x, this->y);
+}
+
+// Catches up a part of the distance between the target and the dead zone
+bn::fixed CameraController::follow(bn::fixed position, bn::fixed target, int dead_zone) {
+    bn::fixed distance = target - position;
+    if(distance > dead_zone) distance -= dead_zone;
+    else if(distance < -dead_zone) distance += dead_zone;
+    else return(position);
+    return(position + bn::fixed::from_data(distance.data() >> CAMERA_SMOOTHING_SHIFT));
+}
+
+void CameraController::shake() {
+    if(this->shake_index == CAMERA_SHAKE_FRAMES) this->shake_index = 0;
+}
+
+void CameraController::update(bn::fixed target_x, bn::fixed target_y) {
+    bn::fixed new_x = bn::clamp(follow(this->x, target_x, CAMERA_DEAD_ZONE_X), this->min_x, this->max_x);
+    bn::fixed new_y = bn::clamp(follow(this->y, target_y, CAMERA_DEAD_ZONE_Y), this->min_y, this->max_y);
+    if(new_x != this->x || new_y != this->y) {
+        this->x = new_x;
+        this->y = new_y;
+        this->camera->set_position(new_x, new_y);
+    }
+
+    if(this->shake_index < CAMERA_SHAKE_FRAMES) {
+        int offset = camera_shake_offsets[this->shake_index];
+        this->shake_bg->set_position(this->shake_x + offset, this->shake_y + offset);
+        this->shake_index += 1;
+    }
+}
@@ -0,0 +1,74 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "collision.h"
+
+unsigned char tile_flags_at(bn::fixed x, bn::fixed y, const CollisionGrid& grid)
+{
+    int x_cell = (x.integer() + 4*grid.columns()) >> 3;
+    int y_cell = (y.integer() + 4*grid.rows()) >> 3;
+    if(x_cell < 0 || y_cell < 0 || x_cell >= grid.columns() || y_cell >= grid.rows()) return 0;
+    return grid.flags(x_cell, y_cell);
+}
+
+static unsigned char grid_flags(const CollisionGrid& grid, int column, int row)
+{
+    if(column < 0 || row < 0 || column >= grid.columns() || row >= grid.rows()) return 0;
+    return grid.flags(column, row);
+}
+
+// Scans the lines from first to last (step : 1 or -1) between the cells min_cross and max_cross of the other axis
+static signed char sweep_lines(const CollisionGrid& grid, bool vertical, int first, int last, int step, int min_cross, int max_cross, unsigned char& spike_flags)
+{
+    for(int line = first; line != last + step; line += step) {
+        for(int cross = min_cross; cross <= max_cross; ++cross) {
+            unsigned char flags = vertical ? grid_flags(grid, cross, line) : grid_flags(grid, line, cross);
+            if(flags & TILE_FLAG_SOLID) return(-step);
+            if((flags & TILE_FLAG_SPIKE) && spike_flags == 0) spike_flags = flags;
+        }
+    }
+    return 0;
+}
+
+CollisionContact sweep_box(bn::fixed x, bn::fixed y, bn::fixed dx, bn::fixed dy, int half_size, const CollisionGrid& grid)
+{
+    CollisionContact contact = {0, 0, 0};
+    int x_offset = 4*grid.columns();
+    int y_offset = 4*grid.rows();
+    int center_x = x.integer() + x_offset;
+    int center_y = y.integer() + y_offset;
+
+    unsigned char center_flags = grid_flags(grid, center_x >> 3, center_y >> 3);
+    if(center_flags & TILE_FLAG_SPIKE) contact.spike_flags = center_flags;
+
+    int top = (center_y - half_size) >> 3;
+    int bottom = (center_y + half_size - 1) >> 3;
+    int target_x = (x + dx).integer() + x_offset;
+    if(dx > 0) {
+        int edge = (center_x + half_size - 1) >> 3;
+        int target_edge = (target_x + half_size - 1) >> 3;
+        if(target_edge > edge) contact.normal_x = sweep_lines(grid, false, edge + 1, target_edge, 1, top, bottom, contact.spike_flags);
+    }
+    else if(dx < 0) {
+        int edge = (center_x - half_size) >> 3;
+        int target_edge = (target_x - half_size) >> 3;
+        if(target_edge < edge) contact.normal_x = sweep_lines(grid, false, edge - 1, target_edge, -1, top, bottom, contact.spike_flags);
+    }
+
+    int left = (center_x - half_size) >> 3;
+    int right = (center_x + half_size - 1) >> 3;
+    int target_y = (y + dy).integer() + y_offset;
+    if(dy > 0) {
+        int edge = (center_y + half_size - 1) >> 3;
+        int target_edge = (target_y + half_size - 1) >> 3;
+        if(target_edge > edge) contact.normal_y = sweep_lines(grid, true, edge + 1, target_edge, 1, left, right, contact.spike_flags);
+    }
+    else if(dy < 0) {
+        int edge = (center_y - half_size) >> 3;
+        int target_edge = (target_y - half_size) >> 3;
+        if(target_edge < edge) contact.normal_y = sweep_lines(grid, true, edge - 1, target_edge, -1, left, right, contact.spike_flags);
+    }
+    return(contact);
+}
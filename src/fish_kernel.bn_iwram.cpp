@@ -0,0 +1,53 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "fish_kernel.h"
+
+int fish_move_kernel(const FishBatch& batch, const FishBounds& bounds, int& expired_count)
+{
+    int moved = 0;
+    int expired = 0;
+    int culled_phase = batch.culled_phase;
+
+    for(int index = 0, count = batch.count; index < count; ++index) {
+        if(batch.state[index] != FISH_STATE_NORMAL) continue;
+        int steps = 1;
+        if(!batch.awake[index]) {
+            if((index & (FISH_CULLED_PERIOD - 1)) != culled_phase) continue;
+            steps = FISH_CULLED_PERIOD;
+        }
+        moved += 1;
+
+        bn::fixed speed_x = batch.speed_x[index];
+        bn::fixed speed_y = batch.speed_y[index];
+        bn::fixed x = batch.x[index] + speed_x * steps;
+        bn::fixed y = batch.y[index] + speed_y * steps;
+        unsigned char direction = batch.direction[index];
+
+        if((y < bounds.top && speed_y < 0) || (y > bounds.bottom && speed_y > 0)) {
+            direction = fish_reflect_y[direction];
+            batch.speed_y[index] = -speed_y;
+        }
+        if((x < bounds.left && speed_x < 0) || (x > bounds.right && speed_x > 0)) {
+            direction = fish_reflect_x[direction];
+            batch.speed_x[index] = -speed_x;
+        }
+
+        batch.x[index] = x;
+        batch.y[index] = y;
+        batch.direction[index] = direction;
+
+        int timer = batch.timer[index] - steps;
+        if(timer <= 0) {
+            timer = 0;
+            batch.expired[expired] = index;
+            expired += 1;
+        }
+        batch.timer[index] = timer;
+    }
+
+    expired_count = expired;
+    return(moved);
+}
@@ -0,0 +1,35 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "fish_view.h"
+
+#include "bn_sprite_tiles_item.h"
+
+FishAnimation::FishAnimation() {
+    this->clock = 0;
+    this->step = 0;
+    for(int type = 0; type < FISH_TYPE_COUNT; type++) {
+        const bn::sprite_tiles_item& tiles_item = fish_sprite_items[type]->tiles_item();
+        for(int frame = 0; frame < FISH_ANIMATION_FRAMES; frame++) {
+            this->idle_tiles[type][frame] = tiles_item.create_tiles(frame);
+        }
+        for(int phase = 0; phase < FISH_ANIMATION_PHASES; phase++) {
+            this->tiles[type][phase] = tiles_item.create_new_tiles(this->frame(phase));
+        }
+    }
+}
+
+void FishAnimation::update() {
+    this->clock += 1;
+    if(this->clock <= FISH_ANIMATION_WAIT) return;
+    this->clock = 0;
+    if(++this->step == FISH_ANIMATION_STEPS) this->step = 0;
+    for(int type = 0; type < FISH_TYPE_COUNT; type++) {
+        const bn::sprite_tiles_item& tiles_item = fish_sprite_items[type]->tiles_item();
+        for(int phase = 0; phase < FISH_ANIMATION_PHASES; phase++) {
+            this->tiles[type][phase]->set_tiles_ref(tiles_item, this->frame(phase));
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "hud.h"
+
+#include "bn_core.h"
+#include "bn_keypad.h"
+#include "bn_string.h"
+#include "bn_sprite_items_spr_lifebar.h"
+#include "bn_sprite_items_spr_counter.h"
+
+Hud::Hud(TextLayer& layer) :
+    text_layer(&layer),
+    lifebar(bn::sprite_items::spr_lifebar.create_sprite(16-GBA_SCREEN_WIDTH/2, 16-GBA_SCREEN_HEIGHT/2)),
+    counter(bn::sprite_items::spr_counter.create_sprite(GBA_SCREEN_WIDTH/2-16, GBA_SCREEN_HEIGHT/2-16)) {
+    for(int state = 0; state < HUD_LIFE_STATES; state++) {
+        this->lifebar_tiles[state] = bn::sprite_items::spr_lifebar.tiles_item().create_tiles(state);
+    }
+}
+
+void Hud::setLife(int value) {
+    if(value == this->life) return;
+    this->life = value;
+    this->lifebar.set_tiles(*this->lifebar_tiles[value]);
+}
+
+void Hud::setScore(int value) {
+    if(value == this->score) return;
+    this->score = value;
+    this->text_layer->print(HUD_SCORE_LINE, HUD_SCORE_X, HUD_SCORE_Y, bn::to_string<16>(value));
+}
+
+#if PROFILER_ENABLED
+void profiler_overlay(TextLayer& text_layer, bool& visible) {
+    if(bn::keypad::select_pressed()) {
+        visible = !visible;
+        if(!visible) {
+            for(int line = 0; line <= PROFILER_SECTIONS; line++) text_layer.clear(PROFILER_FIRST_LINE + line);
+        }
+    }
+    if(!visible || (profiler.frames() % 16) != 0) return;
+
+    for(int section = 0; section < PROFILER_SECTIONS; section++) {
+        int cycles = profiler.average(section);
+        bn::string<48> text = profiler_names[section];
+        text += " ";
+        text += bn::to_string<8>(cycles);
+        text += " ";
+        int bars = cycles * 100 / (GBA_CYCLES_PER_FRAME * PROFILER_BAR_PERCENT);
+        for(int bar = 0; bar < bars && bar < 20; bar++) text += "#";
+        text_layer.print(PROFILER_FIRST_LINE + section, 0, 16*section - 72, text);
+    }
+    bn::string<48> text = "cpu ";
+    text += bn::to_string<8>((bn::core::last_cpu_usage() * 100).integer());
+    text += "%";
+    text_layer.print(PROFILER_FIRST_LINE + PROFILER_SECTIONS, 0, 16*PROFILER_SECTIONS - 72, text);
+}
+#endif
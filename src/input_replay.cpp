@@ -0,0 +1,144 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "input_replay.h"
+
+#include "bn_common.h"
+#include "bn_keypad.h"
+#include "bn_sram.h"
+#include "bn_log.h"
+
+#include "player_core.h"
+
+/*
+    SRAM layout : the header, then the runs of the recording, by chunks
+*/
+struct InputReplayHeader {
+    unsigned magic;
+    unsigned seed;
+    int runs;
+    int score;
+};
+
+struct InputReplayChunk {
+    InputRun runs[INPUT_REPLAY_CHUNK_RUNS];
+};
+
+static_assert(sizeof(InputReplayHeader) + INPUT_REPLAY_CHUNKS * sizeof(InputReplayChunk) <= 32 * 1024, "Input replay too big for SRAM");
+
+BN_DATA_EWRAM InputRun input_replay_runs[INPUT_REPLAY_CHUNKS * INPUT_REPLAY_CHUNK_RUNS];
+
+// Input bitmask of the frame, read from the keypad
+static unsigned keypad_input() {
+    unsigned input = 0;
+    if(bn::keypad::left_held()) input |= PJ_INPUT_LEFT;
+    if(bn::keypad::right_held()) input |= PJ_INPUT_RIGHT;
+    if(bn::keypad::up_held()) input |= PJ_INPUT_UP;
+    if(bn::keypad::down_held()) input |= PJ_INPUT_DOWN;
+    if(bn::keypad::a_pressed()) input |= PJ_INPUT_EAT;
+    return(input);
+}
+
+InputReplay::InputReplay(char input_mode) :
+    log(input_replay_runs, INPUT_REPLAY_CHUNKS * INPUT_REPLAY_CHUNK_RUNS) {
+    this->mode = input_mode;
+    this->seed = 0;
+    this->recorded_score = 0;
+    this->truncated = false;
+    this->script_frame = 0;
+    this->script_input = 0;
+    if(this->mode == INPUT_MODE_PLAYBACK && !this->load()) {
+        BN_LOG("Input replay: no recording in SRAM");
+        this->mode = INPUT_MODE_RECORD;
+    }
+}
+
+bool InputReplay::load() {
+    InputReplayHeader header;
+    bn::sram::read(header);
+    if(header.magic != INPUT_REPLAY_MAGIC || header.runs <= 0 ||
+       header.runs > INPUT_REPLAY_CHUNKS * INPUT_REPLAY_CHUNK_RUNS) {
+        return(false);
+    }
+    InputReplayChunk chunk;
+    InputRun* runs = this->log.data();
+    for(int first = 0; first < header.runs; first += INPUT_REPLAY_CHUNK_RUNS) {
+        bn::sram::read_offset(chunk, sizeof(InputReplayHeader) + first * sizeof(InputRun));
+        for(int index = 0; index < INPUT_REPLAY_CHUNK_RUNS && first + index < header.runs; index++) {
+            runs[first + index] = chunk.runs[index];
+        }
+    }
+    this->log.setSize(header.runs);
+    this->seed = header.seed;
+    this->recorded_score = header.score;
+    return(true);
+}
+
+void InputReplay::save(int score) {
+    InputReplayChunk chunk;
+    const InputRun* runs = this->log.data();
+    for(int first = 0; first < this->log.size(); first += INPUT_REPLAY_CHUNK_RUNS) {
+        for(int index = 0; index < INPUT_REPLAY_CHUNK_RUNS; index++) {
+            chunk.runs[index] = first + index < this->log.size() ? runs[first + index] : InputRun{0, 0};
+        }
+        bn::sram::write_offset(chunk, sizeof(InputReplayHeader) + first * sizeof(InputRun));
+    }
+    // Header last : an interrupted save is not a valid recording
+    InputReplayHeader header = {INPUT_REPLAY_MAGIC, this->seed, this->log.size(), score};
+    bn::sram::write(header);
+}
+
+// A new direction every INPUT_SCRIPT_PERIOD frames, the mouth is opened one time out of two
+unsigned InputReplay::script() {
+    if(this->script_frame % INPUT_SCRIPT_PERIOD == 0) {
+        this->script_input = this->script_random.get_int(PJ_INPUT_EAT << 1);
+    }
+    else {
+        this->script_input &= ~PJ_INPUT_EAT;
+    }
+    this->script_frame += 1;
+    return(this->script_input);
+}
+
+unsigned InputReplay::begin(unsigned record_seed) {
+    if(this->mode == INPUT_MODE_PLAYBACK) {
+        this->log.rewind();
+    }
+    else if(this->mode == INPUT_MODE_SCRIPT) {
+        this->script_random = bn::random();
+        this->script_frame = 0;
+        this->seed = record_seed;
+    }
+    else {
+        this->log.clear();
+        this->seed = record_seed;
+        this->truncated = false;
+    }
+    return(this->seed);
+}
+
+unsigned InputReplay::read() {
+    if(this->mode == INPUT_MODE_PLAYBACK) {
+        return(this->log.play());
+    }
+    if(this->mode == INPUT_MODE_SCRIPT) {
+        return(this->script());
+    }
+    unsigned input = keypad_input();
+    if(!this->log.record(input)) this->truncated = true;
+    return(input);
+}
+
+void InputReplay::end(int score) {
+    if(this->mode == INPUT_MODE_PLAYBACK) {
+        if(score != this->recorded_score || !this->log.finished()) {
+            BN_LOG("Input replay: desync, score ", score, " instead of ", this->recorded_score);
+        }
+    }
+    else if(this->mode == INPUT_MODE_RECORD) {
+        if(this->truncated) BN_LOG("Input replay: recording full, the end of the game is lost");
+        this->save(score);
+    }
+}
@@ -0,0 +1,311 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "player_core.h"
+
+#include "bn_math.h"
+
+constexpr int pj_state_speed_factors[PJ_STATE_COUNT] = {50, 80, 20};   // Standing, eating, swallowing
+
+constexpr PlayerLimits create_player_limits(bn::fixed acceleration) {
+    PlayerLimits limits = {};
+    limits.acceleration = acceleration;
+    for(int state = 0; state < PJ_STATE_COUNT; state++) {
+        limits.maxspeed[state] = acceleration * pj_state_speed_factors[state];
+        limits.maxspeed_reciprocal[state] = (1 << PJ_RECIPROCAL_SHIFT) / limits.maxspeed[state].data();
+    }
+    return(limits);
+}
+
+constexpr PlayerLimits pj_limits[PJ_FX_COUNT] = {
+    create_player_limits(0.03),     // normal
+    create_player_limits(0.09),     // speed
+    create_player_limits(0.03),     // confus
+    create_player_limits(0.03),     // deform
+};
+
+PlayerCore::PlayerCore(bn::fixed x, bn::fixed y, const CollisionGrid& collision_grid, bn::random& rand) {
+    this->grid = &collision_grid;
+    this->random = &rand;
+    this->pos_x = x;
+    this->pos_y = y;
+    this->speed_x = 0;
+    this->speed_y = 0;
+    this->setLimits(PJ_FX_NORMAL);
+    this->setFullLife();
+    this->events = 0;
+    this->setStateStand();
+    this->hurt_timer = 0;
+    this->bg_stretch = 0;
+    this->bg_alpha = 1;
+    this->facing_left = false;
+    this->setFXNormal();
+    this->confus_timer = 0;
+}
+
+/*
+    Background mosaic and blending are global registers : the presentation only
+    writes them back on PJ_EVENT_BACKGROUND.
+*/
+void PlayerCore::set_background(bn::fixed stretch, bn::fixed alpha) {
+    if(stretch != this->bg_stretch || alpha != this->bg_alpha) {
+        this->bg_stretch = stretch;
+        this->bg_alpha = alpha;
+        this->events |= PJ_EVENT_BACKGROUND;
+    }
+}
+
+// The effect acceleration is used at once, its speed limits from the next state change
+void PlayerCore::setLimits(int fx) {
+    this->limits = &pj_limits[fx];
+    this->acceleration = this->limits->acceleration;
+}
+
+void PlayerCore::setMaxspeed() {
+    this->maxspeed = this->limits->maxspeed[int(this->state)];
+    this->maxspeed_reciprocal = this->limits->maxspeed_reciprocal[int(this->state)];
+}
+
+void PlayerCore::heal(short amount) {
+    this->life = this->getLife() + amount;
+    this->life_timer = 0;
+    if(this->life > PJ_LIFE_MAX) this->life = PJ_LIFE_MAX;
+}
+
+void PlayerCore::eat() {
+    this->eaten = true;
+    this->life = this->getLife() + 1;
+    this->life_timer = 0;
+    this->eating_timer = PJ_EATING_ANIMATION_DELAY;
+    if(this->life > PJ_LIFE_MAX) this->life = PJ_LIFE_MAX;
+    this->events |= PJ_EVENT_EAT;
+}
+
+void PlayerCore::hurt(short hurt) {
+    this->events |= PJ_EVENT_HURT;
+    if(this->is_hurt == false) {
+        this->life = this->getLife() - hurt;
+        this->life_timer = 0;
+        this->is_hurt=true;
+    }
+}
+
+void PlayerCore::setFX(char fx) {
+    switch(fx) {
+        case PJ_FX_SPEED:
+            this->setFXSpeed();
+            break;
+        case PJ_FX_CONFUS:
+            this->setFXConfused();
+            break;
+        case PJ_FX_DEFORM:
+            this->setFXDeformation();
+            break;
+        default:
+            this->setFXNormal();
+    }
+}
+
+void PlayerCore::setFXNormal() {
+    this->effect = PJ_FX_NORMAL;
+    this->set_normal_background();
+    this->setLimits(PJ_FX_NORMAL);
+}
+
+void PlayerCore::setFXSpeed() {
+    this->effect = PJ_FX_SPEED;
+    this->set_normal_background();
+    this->setLimits(PJ_FX_SPEED);
+}
+
+void PlayerCore::setFXConfused() {
+    this->effect = PJ_FX_CONFUS;
+    this->set_normal_background();
+    this->setLimits(PJ_FX_CONFUS);
+}
+
+void PlayerCore::setFXDeformation() {
+    this->effect = PJ_FX_DEFORM;
+    this->confus_timer = 0;
+    this->setLimits(PJ_FX_DEFORM);
+}
+
+void PlayerCore::setStateSwallowing() {
+    this->state = PJ_STATE_SWALLOWING;
+    this->setMaxspeed();
+    this->events |= PJ_EVENT_STATE;
+}
+
+void PlayerCore::setStateStand() {
+    this->eaten = false;
+    this->swallowing_timer = 0;
+    this->state = PJ_STATE_STANDING;
+    this->setMaxspeed();
+    this->eating_timer = 0;
+    this->events |= PJ_EVENT_STATE;
+}
+
+void PlayerCore::setStateEat() {
+    this->state = PJ_STATE_EATING;
+    this->setMaxspeed();
+    this->events |= PJ_EVENT_STATE | PJ_EVENT_GRUNT;
+}
+
+// Wall bounce sound (and rumble when the mouth is open)
+void PlayerCore::bounce(bn::fixed speed) {
+    if(this->state == PJ_STATE_EATING) {
+        // abs(speed / maxspeed), from the reciprocal
+        bn::fixed volume = bn::fixed::from_data((bn::abs(speed.data()) * this->maxspeed_reciprocal) >> (PJ_RECIPROCAL_SHIFT - 12));
+        if(volume > 1) volume = 1;
+        if(!(this->events & PJ_EVENT_CHOC) || volume > this->impact_volume) this->impact_volume = volume;
+        this->events |= PJ_EVENT_CHOC;
+    }
+    else{
+        this->events |= PJ_EVENT_BOUNCE;
+    }
+}
+
+void PlayerCore::update(unsigned input) {
+    /*
+     * Player effect
+    */
+    if(this->effect == PJ_FX_DEFORM) {
+        if (this->confus_timer%BG_CONFUSION_RATE==0 && (this->speed_x != 0 || this->speed_y != 0)) {
+            bn::fixed stretch = random->get_fixed(0.5,1);
+            this->set_background(stretch, random->get_fixed(0,1));
+        }
+        this->confus_timer+=1;
+    }
+
+    bn::fixed swept_x = this->speed_x;
+    bn::fixed swept_y = this->speed_y;
+    CollisionContact contact = sweep_box(this->pos_x, this->pos_y, swept_x, swept_y, PJ_HITBOX_HALF_SIZE, *this->grid);
+    bool left_collision = contact.normal_x > 0;
+    bool right_collision = contact.normal_x < 0;
+    bool up_collision = contact.normal_y > 0;
+    bool down_collision = contact.normal_y < 0;
+
+    bool left_held = input & PJ_INPUT_LEFT;
+    bool right_held = input & PJ_INPUT_RIGHT;
+    bool up_held = input & PJ_INPUT_UP;
+    bool down_held = input & PJ_INPUT_DOWN;
+    bool facing_left = this->facing_left;
+
+    if((left_held && !left_collision && this->effect != PJ_FX_CONFUS ) || (right_held && !left_collision && this->effect == PJ_FX_CONFUS)) {
+        if(this->speed_x >= -this->maxspeed) this->speed_x -= this->acceleration;
+        if(this->speed_x <= -this->maxspeed) this->speed_x += this->acceleration;
+        if(this->speed_x < 0) this->facing_left = true;
+    }
+    else if((right_held && !right_collision && this->effect != PJ_FX_CONFUS) || (left_held && !right_collision && this->effect == PJ_FX_CONFUS)) {
+        if(this->speed_x <= this->maxspeed) this->speed_x += this->acceleration;
+        if(this->speed_x >= this->maxspeed) this->speed_x -= this->acceleration;
+        if(this->speed_x > 0) this->facing_left = false;
+    }
+    else {
+        if(this->speed_x < 0 && !left_collision)
+            this->speed_x += this->acceleration;
+        if(this->speed_x > 0 && !right_collision)
+            this->speed_x -= this->acceleration;
+        if (abs(this->speed_x) < this->acceleration) this->speed_x=0;
+    }
+    if(facing_left != this->facing_left) this->events |= PJ_EVENT_FLIP;
+
+    if((up_held && !up_collision && this->effect != PJ_FX_CONFUS) || (down_held && !up_collision && this->effect == PJ_FX_CONFUS)) {
+        if(this->speed_y >= -this->maxspeed) this->speed_y -= this->acceleration;
+        if(this->speed_y <= -this->maxspeed) this->speed_y += this->acceleration;
+    }
+    else if((down_held && !down_collision && this->effect != PJ_FX_CONFUS) || (up_held && !down_collision && this->effect == PJ_FX_CONFUS)) {
+        if(this->speed_y <= this->maxspeed) this->speed_y += this->acceleration;
+        if(this->speed_y >= this->maxspeed) this->speed_y -= this->acceleration;
+    }
+    else {
+        if(this->speed_y < 0 && !up_collision)
+            this->speed_y += this->acceleration;
+        if(this->speed_y > 0 && !down_collision)
+            this->speed_y -= this->acceleration;
+        if (abs(this->speed_y) < this->acceleration) this->speed_y=0;
+    }
+
+    if(contact.normal_x != 0) {
+        // Bounce away from the wall
+        this->speed_x = contact.normal_x > 0 ? abs(this->speed_x) : -abs(this->speed_x);
+        this->bounce(this->speed_x);
+    }
+    if(contact.normal_y != 0) {
+        this->speed_y = contact.normal_y > 0 ? abs(this->speed_y) : -abs(this->speed_y);
+        this->bounce(this->speed_y);
+    }
+
+    //Spikes collision
+    if(contact.spike_flags & TILE_FLAG_SPIKE) {
+        switch(contact.spike_flags & TILE_PUSH_MASK) {
+            case TILE_PUSH_LEFT:
+                this->speed_x = -this->maxspeed; //left_spikes
+                break;
+            case TILE_PUSH_RIGHT:
+                this->speed_x = this->maxspeed; //right_spikes
+                break;
+            case TILE_PUSH_UP:
+                this->speed_y = -this->maxspeed; //up_spikes
+                break;
+            default:
+                this->speed_y = this->maxspeed; //down_spikes
+        }
+        this->hurt();
+    }
+
+    /*
+     * Move by the final speed : input, bounces and spike pushes may have changed the swept one
+     * (a spike can push back into the wall just bounced on). An axis blocked by a wall keeps
+     * its position, the next update bounces on it.
+    */
+    if(contact.normal_x != 0 || contact.normal_y != 0 || this->speed_x != swept_x || this->speed_y != swept_y) {
+        CollisionContact move = sweep_box(this->pos_x, this->pos_y, this->speed_x, this->speed_y, PJ_HITBOX_HALF_SIZE, *this->grid);
+        if(move.normal_x == 0) this->pos_x += this->speed_x;
+        if(move.normal_y == 0) this->pos_y += this->speed_y;
+    }
+    else {
+        this->pos_x += this->speed_x;
+        this->pos_y += this->speed_y;
+    }
+
+    if(this->state == PJ_STATE_SWALLOWING) {
+        this->swallowing_timer += 1;
+        if(this->swallowing_timer >= PJ_SWALLOW_ANIMATION_DELAY) {
+            this->setStateStand();
+        }
+    }
+
+    if(this->state == PJ_STATE_EATING) {
+        this->eating_timer += 1;
+        if(this->eating_timer >= PJ_EATING_ANIMATION_DELAY) {
+            if(this->eaten == true)
+                this->setStateSwallowing();
+            else
+                this->setStateStand();
+        }
+    }
+
+    // Invincible si trop de collisions simultanées
+    if(this->is_hurt) {
+        this->hurt_timer++;
+        if(this->hurt_timer >= PJ_INVINCIBLE_DELAY) {
+            this->is_hurt = false;
+            this->hurt_timer = 0;
+        }
+    }
+
+    if(this->life > 0) {
+        this->life_timer += 1;
+        if(this->life_timer == PJ_LIFE_DRAIN_FRAMES) {
+            this->life -= 1;
+            this->life_timer = 0;
+        }
+    }
+    else {
+        this->life = 0;
+        this->life_timer = 0;
+    }
+}
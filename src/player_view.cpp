@@ -0,0 +1,56 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "player_view.h"
+
+#include "bn_bgs_mosaic.h"
+#include "bn_blending.h"
+#include "bn_sprite_items_pj.h"
+
+void PlayerView::setAnimation(char state) {
+    switch(state) {
+        case PJ_STATE_EATING:
+            this->animation = bn::create_sprite_animate_action_forever(this->sprite, 32, bn::sprite_items::pj.tiles_item(), 4, 5, 6, 7);
+            break;
+        case PJ_STATE_SWALLOWING:
+            this->animation = bn::create_sprite_animate_action_forever(this->sprite, 32, bn::sprite_items::pj.tiles_item(), 8, 9, 10, 11);
+            break;
+        default:
+            this->animation = bn::create_sprite_animate_action_forever(this->sprite, 32, bn::sprite_items::pj.tiles_item(), 0, 1, 2, 3);
+    }
+}
+
+PlayerView::PlayerView(const PlayerCore& core, bn::camera_ptr& cam, CameraController& camera_control, SoundEvents& sound_events) :
+    sprite(bn::sprite_items::pj.create_sprite(core.x(), core.y())) {
+    this->camera_controller = &camera_control;
+    this->sounds = &sound_events;
+    this->sprite.set_camera(cam);
+    this->setAnimation(core.getState());
+}
+
+void PlayerView::update(PlayerCore& core) {
+    unsigned events = core.takeEvents();
+    if(events & PJ_EVENT_STATE) this->setAnimation(core.getState());
+    if(events & PJ_EVENT_GRUNT) this->sounds->request(SOUND_GRUNT);
+    if(events & PJ_EVENT_EAT) this->sounds->request(SOUND_EAT);
+    if(events & PJ_EVENT_HURT) {
+        this->camera_controller->shake();
+        this->sounds->request(SOUND_SPIKE);
+    }
+    if(events & PJ_EVENT_CHOC) {
+        this->camera_controller->shake();
+        this->sounds->request(SOUND_CHOC, core.impact());
+    }
+    if(events & PJ_EVENT_BOUNCE) this->sounds->request(SOUND_BOING);
+    if(events & PJ_EVENT_FLIP) this->sprite.set_horizontal_flip(core.facingLeft());
+    if(events & PJ_EVENT_BACKGROUND) {
+        bn::bgs_mosaic::set_stretch(core.backgroundStretch());
+        bn::blending::set_transparency_alpha(core.backgroundAlpha());
+    }
+
+    if(core.x() != this->sprite.x() || core.y() != this->sprite.y()) this->sprite.set_position(core.x(), core.y());
+
+    this->animation->update();
+}
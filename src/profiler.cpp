@@ -0,0 +1,10 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "profiler.h"
+
+#if PROFILER_ENABLED
+Profiler profiler;
+#endif
@@ -0,0 +1,318 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "scenes.h"
+
+#include "bn_core.h"
+#include "bn_keypad.h"
+#include "bn_random.h"
+#include "bn_string.h"
+#include "bn_blending.h"
+#include "bn_bgs_mosaic.h"
+#include "bn_camera_ptr.h"
+#include "bn_regular_bg_ptr.h"
+#include "bn_sprite_items_pj.h"
+#include "bn_regular_bg_items_lvl0.h"
+#include "bn_regular_bg_items_title.h"
+#include "bn_music_items.h"
+#include "collision_items_lvl0.h"
+#include "collision_items_title.h"
+
+#include "world.h"
+#include "game_sim.h"
+#include "player_view.h"
+#include "camera_controller.h"
+#include "streamed_level.h"
+#include "sound_events.h"
+#include "text_layer.h"
+#include "hud.h"
+#include "profiler.h"
+#include "bench.h"
+
+int GameAssets::loadStage(int stage) {
+    switch(stage) {
+        case 0:
+            // The map itself is streamed by the game
+            this->lvl0_tiles = bn::regular_bg_items::lvl0.tiles_item().create_tiles();
+            this->lvl0_palette = bn::regular_bg_items::lvl0.palette_item().create_palette();
+            return(SCENE_STAGE_VBLANK);
+        case 1:
+            this->fish_animation.emplace();
+            return(SCENE_STAGE_VBLANK);
+        case 2:
+            // Found again by the piranha create_sprite()
+            this->pj_tiles = bn::sprite_items::pj.tiles_item().create_tiles();
+            this->pj_palette = bn::sprite_items::pj.palette_item().create_palette();
+            return(SCENE_STAGE_VBLANK);
+        default:
+            return(SCENE_STAGE_DONE);
+    }
+}
+
+void GameAssets::clear() {
+    this->lvl0_tiles.reset();
+    this->lvl0_palette.reset();
+    this->fish_animation.reset();
+    this->pj_tiles.reset();
+    this->pj_palette.reset();
+}
+
+// seed : seed of the random generator when recording (see InputReplay::begin())
+int game(OceanBackdrop& backdrop, InputReplay& input, unsigned seed, GameAssets& assets) {
+    /*
+        Create and init regular background
+        Streamed from ROM : only the cells exposed by the camera are written
+    */
+    bn::camera_ptr camera = bn::camera_ptr::create(0, 0);
+
+    bn::bgs_mosaic::set_stretch(0);
+    bn::blending::set_transparency_alpha(1);
+    StreamedLevel lvl0(bn::regular_bg_items::lvl0, *assets.lvl0_tiles, *assets.lvl0_palette, camera);
+    lvl0.background().set_blending_enabled(true);
+    lvl0.background().set_mosaic_enabled(true);
+
+    const CollisionGrid& lvl0_grid = collision_items::lvl0;
+    //lvl0.put_above(); //To put above other bg !
+
+    /*
+        Create and init sprites
+    */
+    TextLayer text_layer(HUD_TEXT_LINES);
+    Hud hud(text_layer);
+#if PROFILER_ENABLED
+    bool profiler_visible = false;
+#endif
+
+    /* Random generator, seeded for the input replay */
+    bn::random random = bn::random();
+    random.set_seed(input.begin(seed));
+
+    /*
+        Camera, clamped to lvl0 : the piranha starts at (0, 0)
+    */
+    CameraController camera_controller(camera, lvl0.background(), lvl0.width(), lvl0.height(), 0, 0);
+
+    /*
+        Musique BG
+    */
+    bn::music_items::music.play(0.5);
+
+    // Every fish in play can have a sprite : no edible fish is left invisible
+#if BENCH_ENABLED
+    #define FISH_SPRITE_MAX_NUMBER FISH_MAX_NUMBER
+#else
+    #define FISH_SPRITE_MAX_NUMBER FISH_GAME_MAX_NUMBER
+#endif
+    GameSim<FISH_MAX_NUMBER> sim(random, lvl0.width(), lvl0.height(), lvl0_grid);
+    FishAnimation& fish_animation = *assets.fish_animation;
+    FishView<FISH_MAX_NUMBER, FISH_SPRITE_MAX_NUMBER> fish_view(sim.fish, camera, fish_animation);
+#if BENCH_ENABLED
+    // Benchmark at full load
+    while(sim.fish.size() < FISH_MAX_NUMBER) {
+        createFish(sim.fish, sim.fish_context, sim.fish_type);
+    }
+    sim.fish_number = FISH_MAX_NUMBER;
+    int bench_frames = 0;
+    BENCH_CHECK("level_start", lvl0.check());
+#endif
+   
+    //int a=0;
+
+    SoundEvents sound_events;
+    PlayerView player_view(sim.player, camera, camera_controller, sound_events);
+
+    //bn::string<11> str_state = "";
+
+    while(true)
+    {
+        PROFILER_BEGIN(PROFILER_FISH);
+        sim.step(input.read(), camera_controller.getX(), camera_controller.getY());
+        PROFILER_END(PROFILER_FISH);
+
+        // Before the sprites are placed from the camera
+        PROFILER_BEGIN(PROFILER_CAMERA);
+        camera_controller.update(sim.player.x(), sim.player.y());
+        lvl0.update(camera_controller.getX(), camera_controller.getY());
+        PROFILER_END(PROFILER_CAMERA);
+
+        PROFILER_BEGIN(PROFILER_FISH);
+        fish_animation.update();
+        fish_view.update();
+        PROFILER_END(PROFILER_FISH);
+
+        PROFILER_BEGIN(PROFILER_PLAYER);
+        player_view.update(sim.player);
+        sound_events.update();
+        PROFILER_END(PROFILER_PLAYER);
+
+        PROFILER_BEGIN(PROFILER_BACKDROP);
+        backdrop.update(ocean_wobble);
+        PROFILER_END(PROFILER_BACKDROP);
+
+        PROFILER_BEGIN(PROFILER_HUD);
+        hud.setScore(sim.fish_points);
+        hud.setLife(sim.player.getLife()); //Lifebar update
+        PROFILER_END(PROFILER_HUD);
+
+#if BENCH_ENABLED
+        // The piranha never dies, the game lasts BENCH_GAME_FRAMES
+        if(sim.over()) sim.player.setFullLife();
+        bench_frames += 1;
+        if(bench_frames == BENCH_GAME_FRAMES) {
+            // The ring map after a game of scrolling
+            BENCH_CHECK("level_end", lvl0.check());
+            return(sim.fish_points);
+        }
+#endif
+        if(sim.over()) {
+            input.end(sim.fish_points);
+            return(sim.fish_points);
+        }
+
+#if PROFILER_ENABLED
+        profiler_overlay(text_layer, profiler_visible);
+#endif
+        PROFILER_FRAME();
+        BENCH_FRAME("game");
+        bn::core::update();
+    }
+}
+
+#if BENCH_ENABLED
+    #define TITLE_AUTOSTART_FRAME   BENCH_TITLE_FRAMES
+#else
+    #define TITLE_AUTOSTART_FRAME   0       // As soon as "press start" is shown
+#endif
+
+// Returns the number of frames spent on the screen, autostart : no need to press start
+int title(OceanBackdrop& backdrop, bool autostart, SceneLoader<GameAssets>& game_loader) {
+    bn::camera_ptr camera = bn::camera_ptr::create(0, 0);
+
+    /*
+        Create and init regular background
+    */
+    bn::regular_bg_ptr title_bg = bn::regular_bg_items::title.create_bg(0, 0);
+    
+    const CollisionGrid& title_grid = collision_items::title;
+
+    title_bg.set_priority(0);
+
+    /*
+        Create and init sprites
+    */
+    #define TITLE_CREDITS_LINE  0
+    #define TITLE_JAM_LINE      1
+    #define TITLE_START_LINE    2
+    TextLayer text_layer(TITLE_START_LINE + 1);
+    // Text is only printed when the screen changes, "press start" blinks by visibility
+    text_layer.print(TITLE_CREDITS_LINE, 0, 0, "jeremyK6 & Bugmobile");
+    text_layer.print(TITLE_JAM_LINE, 0, 16, "Juice Jam II - Made with Butano");
+    bool start_printed = false;
+
+    /*
+        Musique BG
+    */
+    bn::music_items::title.play(0.5);
+
+    bool title_screen = true;
+    int timer = 0;
+
+    /* Random generator */
+    bn::random random = bn::random();
+
+    #define TITLE_FISH_MAX_NUMBER 50
+    FishContext fish_context = create_fish_context(random, title_bg.dimensions().width(), title_bg.dimensions().height(), title_grid);
+    #define TITLE_SPAWN_FRAMES 10   // The fish are created over 10 frames, before they swim
+    FishSim<TITLE_FISH_MAX_NUMBER> fish_sim(fish_context);
+    // Fish tiles are only created before the spawn
+    bn::optional<FishAnimation> fish_animation;
+    bn::optional<FishView<TITLE_FISH_MAX_NUMBER, TITLE_FISH_MAX_NUMBER>> fish_view;
+    char fish_type = FISH_TYPE_DEFORMATION;
+    int start_time = 60*4-32;
+
+    while(title_screen)
+    {
+        if (timer == start_time - TITLE_SPAWN_FRAMES - 1)
+        {
+            fish_animation.emplace();
+            fish_view.emplace(fish_sim, camera, *fish_animation);
+        }
+        if (timer >= start_time - TITLE_SPAWN_FRAMES && timer < start_time)
+        {
+            for(char i = 0; i < TITLE_FISH_MAX_NUMBER / TITLE_SPAWN_FRAMES; i++) {
+            createFish(fish_sim, fish_context, fish_type);
+            }
+        }
+        if (timer > start_time)
+        {
+            fish_sim.update(camera.x(), camera.y());
+            fish_animation->update();
+            fish_view->update();
+        }
+
+        backdrop.update(ocean_wobble);
+
+        if (timer > 60*4)
+        {
+            if(!start_printed) {
+                text_layer.clear(TITLE_CREDITS_LINE);
+                text_layer.clear(TITLE_JAM_LINE);
+                text_layer.print(TITLE_START_LINE, 0, 32, "press start");
+                start_printed = true;
+            }
+            text_layer.setVisible(TITLE_START_LINE, (timer/32)%2==0);
+            // The fish are all shown : the game is loaded during "press start"
+            game_loader.update();
+            if(bn::keypad::start_pressed() || (autostart && timer >= TITLE_AUTOSTART_FRAME)) {
+            title_screen = false;
+            }
+        }
+        BENCH_FRAME("title");
+        bn::core::update();
+        timer++;
+    }
+    return timer;
+}
+
+#define RESULTS_AUTOSTART_DELAY 120
+
+// autostart : leaves the screen after RESULTS_AUTOSTART_DELAY frames
+int results(int score, OceanBackdrop& backdrop, bool autostart) {
+    bn::camera_ptr camera = bn::camera_ptr::create(0, 0);
+
+    /*
+        Create and init sprites
+    */
+    #define RESULTS_TITLE_LINE  0
+    #define RESULTS_SCORE_LINE  1
+    #define RESULTS_START_LINE  2
+    TextLayer text_layer(RESULTS_START_LINE + 1);
+    // Static text : printed once for the whole screen
+    text_layer.print(RESULTS_TITLE_LINE, 0, -32, "SCORE :");
+    text_layer.print(RESULTS_SCORE_LINE, 0, -16, bn::to_string<32>(score));
+    text_layer.print(RESULTS_START_LINE, 0, 32, "press start");
+
+    /*
+        Musique BG
+    */
+    bn::music_items::score.play(1);
+
+    bool title_screen = true;
+    int timer = 0;
+
+    while(title_screen)
+    {
+        if(bn::keypad::start_pressed() || (autostart && timer == RESULTS_AUTOSTART_DELAY)) {
+            title_screen = false;
+        }
+        timer++;
+
+        backdrop.update(ocean_wobble);
+
+        BENCH_FRAME("results");
+        bn::core::update();
+    }
+    return 0;
+}
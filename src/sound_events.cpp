@@ -0,0 +1,91 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "sound_events.h"
+
+#include "bn_sound_items.h"
+
+/*
+    Effects description
+    cooldown : frames before an effect can start again, so a piranha stuck against a wall
+    or on spikes doesn't start a sound every frame. Higher priorities steal the voices of
+    lower ones.
+*/
+struct SoundDescriptor {
+    const bn::sound_item* item;
+    unsigned char cooldown;
+    unsigned char priority;
+};
+
+constexpr SoundDescriptor sound_descriptors[SOUND_COUNT] = {
+    // item                          cooldown    priority
+    { &bn::sound_items::grunting,    8,          2 },    // grunt
+    { &bn::sound_items::eating,      4,          3 },    // eat
+    { &bn::sound_items::spike,       20,         4 },    // spike
+    { &bn::sound_items::choc,        12,         1 },    // choc
+    { &bn::sound_items::boing,       12,         0 },    // boing
+};
+
+constexpr bool sound_priorities_valid() {
+    for(const SoundDescriptor& descriptor : sound_descriptors) {
+        if(descriptor.priority > SOUND_PRIORITY_MAX) return(false);
+    }
+    return(true);
+}
+static_assert(sound_priorities_valid(), "A sound priority is above SOUND_PRIORITY_MAX");
+
+SoundEvents::SoundEvents() {
+    for(int effect = 0; effect < SOUND_COUNT; effect++) {
+        this->requested[effect] = 0;
+        this->cooldown[effect] = 0;
+    }
+}
+
+void SoundEvents::request(int effect, bn::fixed volume) {
+    if(volume > this->requested[effect]) this->requested[effect] = volume;
+}
+
+// Returns a voice that is not playing, or -1
+int SoundEvents::freeVoice() {
+    for(int voice = 0; voice < SOUND_VOICE_MAX; voice++) {
+        if(!this->voices[voice].handle || !this->voices[voice].handle->active()) return(voice);
+    }
+    return(-1);
+}
+
+void SoundEvents::play(int effect) {
+    const SoundDescriptor& descriptor = sound_descriptors[effect];
+    int voice = this->freeVoice();
+    if(voice < 0) {
+        // Steals the voice of the lowest priority effect, if lower than this one
+        int lowest_priority = descriptor.priority;
+        for(int index = 0; index < SOUND_VOICE_MAX; index++) {
+            int priority = sound_descriptors[this->voices[index].effect].priority;
+            if(priority < lowest_priority) {
+                lowest_priority = priority;
+                voice = index;
+            }
+        }
+        if(voice < 0) return;
+        this->voices[voice].handle->stop();
+    }
+    this->voices[voice].handle = descriptor.item->play(this->requested[effect]);
+    this->voices[voice].effect = effect;
+    this->cooldown[effect] = descriptor.cooldown;
+}
+
+void SoundEvents::update() {
+    // Highest priority first : they get the voices
+    for(int priority = SOUND_PRIORITY_MAX; priority >= 0; priority--) {
+        for(int effect = 0; effect < SOUND_COUNT; effect++) {
+            if(sound_descriptors[effect].priority != priority || this->requested[effect] == 0) continue;
+            if(this->cooldown[effect] == 0) this->play(effect);
+            this->requested[effect] = 0;
+        }
+    }
+    for(int effect = 0; effect < SOUND_COUNT; effect++) {
+        if(this->cooldown[effect] > 0) this->cooldown[effect] -= 1;
+    }
+}
@@ -0,0 +1,132 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "streamed_level.h"
+
+#include "bn_assert.h"
+#include "bn_algorithm.h"
+#include "bn_regular_bg_map_item.h"
+#include "bn_regular_bg_map_cell_info.h"
+
+#include "world.h"
+
+#define LEVEL_VIEW_COLUMNS  (GBA_SCREEN_WIDTH/8 + 1 + 2*LEVEL_MARGIN_CELLS)
+#define LEVEL_VIEW_ROWS     (GBA_SCREEN_HEIGHT/8 + 1 + 2*LEVEL_MARGIN_CELLS)
+
+static_assert(LEVEL_VIEW_COLUMNS <= LEVEL_RING_COLUMNS && LEVEL_VIEW_ROWS <= LEVEL_RING_ROWS, "Level ring map too small");
+
+StreamedLevel::StreamedLevel(const bn::regular_bg_item& item, const bn::regular_bg_tiles_ptr& tiles, const bn::bg_palette_ptr& palette,
+                             bn::camera_ptr& camera) :
+    map_item(item.map_item()),
+    map(bn::regular_bg_map_ptr::allocate(bn::size(LEVEL_RING_COLUMNS, LEVEL_RING_ROWS), tiles, palette)),
+    bg(bn::regular_bg_ptr::create(this->map)) {
+    BN_ASSERT(this->map_item.compression() == bn::compression_type::NONE, "Compressed level map");
+    this->columns = this->map_item.dimensions().width();
+    this->rows = this->map_item.dimensions().height();
+
+    /*
+        Ring cell 0 on level cell 0 : the level is centered on (0, 0) like a regular
+        background, the ring map on its position (modulo its size)
+    */
+    this->bg.set_position(LEVEL_RING_COLUMNS*4 - this->width()/2, LEVEL_RING_ROWS*4 - this->height()/2);
+    this->bg.set_camera(camera);
+
+    // The view starts in the middle of the ring
+    int first_column = this->viewColumn(camera.x()) - (LEVEL_RING_COLUMNS - LEVEL_VIEW_COLUMNS) / 2;
+    int first_row = this->viewRow(camera.y()) - (LEVEL_RING_ROWS - LEVEL_VIEW_ROWS) / 2;
+    this->first_column = bn::clamp(first_column, 0, bn::max(this->columns - LEVEL_RING_COLUMNS, 0));
+    this->first_row = bn::clamp(first_row, 0, bn::max(this->rows - LEVEL_RING_ROWS, 0));
+    bn::regular_bg_map_cell* vram = this->map.vram()->data();
+    int last_column = bn::min(this->first_column + LEVEL_RING_COLUMNS, this->columns);
+    for(int column = this->first_column; column < last_column; column++) {
+        this->writeColumn(vram, column);
+    }
+}
+
+// Ring cell of a level cell : a 64x32 map is two 32x32 screen blocks, side by side
+static int ring_index(int column, int row) {
+    int x = column & (LEVEL_RING_COLUMNS - 1);
+    int y = row & (LEVEL_RING_ROWS - 1);
+    return(((x >> 5) << 10) + (y << 5) + (x & 31));
+}
+
+bn::regular_bg_map_cell StreamedLevel::levelCell(int column, int row) const {
+    bn::regular_bg_map_cell_info info(this->map_item.cell(column, row));
+    info.set_tile_index(info.tile_index() + this->map.tiles_offset());
+    info.set_palette_id(info.palette_id() + this->map.palettes_offset());
+    return(info.cell());
+}
+
+void StreamedLevel::writeCell(bn::regular_bg_map_cell* vram, int column, int row) {
+    vram[ring_index(column, row)] = this->levelCell(column, row);
+}
+
+void StreamedLevel::writeColumn(bn::regular_bg_map_cell* vram, int column) {
+    int last_row = bn::min(this->first_row + LEVEL_RING_ROWS, this->rows);
+    for(int row = this->first_row; row < last_row; row++) {
+        this->writeCell(vram, column, row);
+    }
+}
+
+void StreamedLevel::writeRow(bn::regular_bg_map_cell* vram, int row) {
+    int last_column = bn::min(this->first_column + LEVEL_RING_COLUMNS, this->columns);
+    for(int column = this->first_column; column < last_column; column++) {
+        this->writeCell(vram, column, row);
+    }
+}
+
+int StreamedLevel::viewColumn(bn::fixed camera_x) const {
+    return(((camera_x.integer() - GBA_SCREEN_WIDTH/2 + this->width()/2) >> 3) - LEVEL_MARGIN_CELLS);
+}
+
+int StreamedLevel::viewRow(bn::fixed camera_y) const {
+    return(((camera_y.integer() - GBA_SCREEN_HEIGHT/2 + this->height()/2) >> 3) - LEVEL_MARGIN_CELLS);
+}
+
+void StreamedLevel::update(bn::fixed camera_x, bn::fixed camera_y) {
+    // The ring only moves by the cells the view went past
+    int view_column = this->viewColumn(camera_x);
+    int first_column = this->first_column;
+    if(view_column < first_column) first_column = view_column;
+    else if(view_column + LEVEL_VIEW_COLUMNS > first_column + LEVEL_RING_COLUMNS) first_column = view_column + LEVEL_VIEW_COLUMNS - LEVEL_RING_COLUMNS;
+    first_column = bn::clamp(first_column, 0, bn::max(this->columns - LEVEL_RING_COLUMNS, 0));
+
+    int view_row = this->viewRow(camera_y);
+    int first_row = this->first_row;
+    if(view_row < first_row) first_row = view_row;
+    else if(view_row + LEVEL_VIEW_ROWS > first_row + LEVEL_RING_ROWS) first_row = view_row + LEVEL_VIEW_ROWS - LEVEL_RING_ROWS;
+    first_row = bn::clamp(first_row, 0, bn::max(this->rows - LEVEL_RING_ROWS, 0));
+
+    if(first_column == this->first_column && first_row == this->first_row) return;
+
+    bn::regular_bg_map_cell* vram = this->map.vram()->data();
+    if(first_column != this->first_column) {
+        int old_first = this->first_column;
+        this->first_column = first_column;
+        // Only the columns that were not held
+        for(int column = first_column; column < first_column + LEVEL_RING_COLUMNS && column < this->columns; column++) {
+            if(column < old_first || column >= old_first + LEVEL_RING_COLUMNS) this->writeColumn(vram, column);
+        }
+    }
+    if(first_row != this->first_row) {
+        int old_first = this->first_row;
+        this->first_row = first_row;
+        for(int row = first_row; row < first_row + LEVEL_RING_ROWS && row < this->rows; row++) {
+            if(row < old_first || row >= old_first + LEVEL_RING_ROWS) this->writeRow(vram, row);
+        }
+    }
+}
+
+bool StreamedLevel::check() {
+    const bn::regular_bg_map_cell* vram = this->map.vram()->data();
+    int last_column = bn::min(this->first_column + LEVEL_RING_COLUMNS, this->columns);
+    int last_row = bn::min(this->first_row + LEVEL_RING_ROWS, this->rows);
+    for(int row = this->first_row; row < last_row; row++) {
+        for(int column = this->first_column; column < last_column; column++) {
+            if(vram[ring_index(column, row)] != this->levelCell(column, row)) return(false);
+        }
+    }
+    return(true);
+}
@@ -0,0 +1,181 @@
+/*
+ * Authors : Bugmobile & jeremyk6
+ * License : GPLv3
+ */
+
+#include "text_layer.h"
+
+#include "bn_tile.h"
+#include "bn_assert.h"
+#include "bn_algorithm.h"
+#include "bn_sprite_font.h"
+#include "bn_bg_palette_item.h"
+#include "bn_bg_palette_ptr.h"
+#include "bn_sprite_tiles_item.h"
+#include "bn_regular_bg_map_cell_info.h"
+
+#include "common_variable_8x16_sprite_font.h"
+#include "world.h"
+
+static BN_DATA_EWRAM bn::tile text_layer_buffer[TEXT_LAYER_LINE_TILES];
+
+void TextLayer::writeCells(int line, bool show) {
+    bn::span<bn::regular_bg_map_cell> cells = *this->map.vram();
+    int first_tile = 1 + line * TEXT_LAYER_LINE_TILES;
+    bn::regular_bg_map_cell_info info;
+    info.set_palette_id(this->map.palettes_offset());
+    for(int half = 0; half < 2; half++) {
+        int row = this->line_row[line] + half;
+        for(int column = 0; column < TEXT_LAYER_COLUMNS; column++) {
+            info.set_tile_index(this->map.tiles_offset() + (show ? first_tile + half * TEXT_LAYER_COLUMNS + column : 0));
+            cells[row * TEXT_LAYER_MAP_SIZE + column] = info.cell();
+        }
+    }
+}
+
+// Glyphs start at ' ', other characters are drawn as spaces
+static int glyph_of(char character) {
+    return((character > ' ' && character <= '~') ? character - ' ' : 0);
+}
+
+TextLayer::TextLayer(int lines) :
+    lines(lines),
+    tiles(bn::regular_bg_tiles_ptr::allocate(1 + lines * TEXT_LAYER_LINE_TILES, bn::bpp_mode::BPP_4)),
+    map(bn::regular_bg_map_ptr::allocate(bn::size(TEXT_LAYER_MAP_SIZE, TEXT_LAYER_MAP_SIZE), this->tiles,
+        bn::bg_palette_item(common::variable_8x16_sprite_font.item().palette_item().colors_ref(), bn::bpp_mode::BPP_4).create_palette())),
+    bg(bn::regular_bg_ptr::create(TEXT_LAYER_MAP_SIZE*4-GBA_SCREEN_WIDTH/2, TEXT_LAYER_MAP_SIZE*4-GBA_SCREEN_HEIGHT/2, this->map)) {
+    BN_ASSERT(lines > 0 && lines <= TEXT_LAYER_LINES_MAX, "Invalid text layer lines: ", lines);
+    this->bg.set_priority(0);
+    this->bg.put_above();
+
+    for(bn::tile& tile : *this->tiles.vram()) {
+        for(int row = 0; row < 8; row++) tile.data[row] = 0;
+    }
+    bn::regular_bg_map_cell_info info;
+    info.set_palette_id(this->map.palettes_offset());
+    info.set_tile_index(this->map.tiles_offset());
+    for(bn::regular_bg_map_cell& cell : *this->map.vram()) {
+        cell = info.cell();
+    }
+    for(int line = 0; line < lines; line++) {
+        this->line_row[line] = -1;
+        this->line_visible[line] = false;
+        this->line_length[line] = 0;
+        this->line_pen[line] = 0;
+        this->line_end[line] = 0;
+    }
+}
+
+void TextLayer::print(int line, int x, int y, const bn::string_view& text) {
+    BN_ASSERT(line >= 0 && line < this->lines, "Invalid text layer line: ", line);
+    BN_ASSERT(text.size() <= TEXT_LAYER_TEXT_MAX, "Text too long: ", text.size());
+    const bn::sprite_font& font = common::variable_8x16_sprite_font;
+    const bn::sprite_tiles_item& glyphs = font.item().tiles_item();
+    bn::span<const int8_t> widths = font.character_widths_ref();
+    int spacing = font.space_between_characters();
+    int length = text.size();
+
+    int width = 0;
+    for(char character : text) {
+        width += widths[glyph_of(character)] + spacing;
+    }
+    // No spacing after the last glyph, as sprite_text_generator
+    if(length) width -= spacing;
+    int pen = x + GBA_SCREEN_WIDTH/2 - width/2;
+    int end = bn::clamp((pen + width + 7) >> 3, 0, TEXT_LAYER_COLUMNS);
+
+    /*
+        Columns to compose : from the first glyph that differs when the text starts at the
+        same place, from the start of both texts otherwise, up to the end of the longest one
+    */
+    const char* previous = this->line_text[line];
+    int start;
+    if(pen == this->line_pen[line]) {
+        int same = 0;
+        int same_pen = pen;
+        while(same < length && same < this->line_length[line] && text[same] == previous[same]) {
+            same_pen += widths[glyph_of(text[same])] + spacing;
+            same += 1;
+        }
+        start = same == length && same == this->line_length[line] ? TEXT_LAYER_COLUMNS : same_pen >> 3;
+    }
+    else {
+        start = bn::min(pen, int(this->line_pen[line])) >> 3;
+    }
+    start = bn::clamp(start, 0, TEXT_LAYER_COLUMNS);
+    int last = bn::max(end, int(this->line_end[line]));
+
+    if(start < last) {
+        for(int half = 0; half < 2; half++) {
+            for(int column = start; column < last; column++) {
+                for(int row = 0; row < 8; row++) text_layer_buffer[half * TEXT_LAYER_COLUMNS + column].data[row] = 0;
+            }
+        }
+        // Glyphs before the start column are skipped, the ones crossing it are drawn again
+        int glyph_pen = pen;
+        for(char character : text) {
+            int glyph = glyph_of(character);
+            int glyph_width = widths[glyph];
+            if(glyph_pen >= last * 8) break;
+            if(glyph_pen + glyph_width > start * 8) {
+                bn::span<const bn::tile> glyph_tiles = glyphs.graphics_tiles_ref(glyph);
+                int column = glyph_pen >> 3;
+                int shift = (glyph_pen & 7) * 4;
+                for(int half = 0; half < 2; half++) {
+                    bn::tile* first = text_layer_buffer + half * TEXT_LAYER_COLUMNS;
+                    for(int row = 0; row < 8; row++) {
+                        unsigned int pixels = glyph_tiles[half].data[row];
+                        if(pixels == 0) continue;
+                        if(column >= start && column < last) first[column].data[row] |= pixels << shift;
+                        if(shift && column + 1 >= start && column + 1 < last) first[column + 1].data[row] |= pixels >> (32 - shift);
+                    }
+                }
+            }
+            glyph_pen += glyph_width + spacing;
+        }
+
+        // Only the tiles that have changed
+        bn::span<bn::tile> line_tiles = this->tiles.vram()->subspan(1 + line * TEXT_LAYER_LINE_TILES, TEXT_LAYER_LINE_TILES);
+        for(int half = 0; half < 2; half++) {
+            for(int column = start; column < last; column++) {
+                int index = half * TEXT_LAYER_COLUMNS + column;
+                const bn::tile& source = text_layer_buffer[index];
+                bn::tile& destination = line_tiles[index];
+                for(int row = 0; row < 8; row++) {
+                    if(source.data[row] != destination.data[row]) {
+                        destination = source;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    for(int index = 0; index < length; index++) {
+        this->line_text[line][index] = text[index];
+    }
+    this->line_length[line] = length;
+    this->line_pen[line] = pen;
+    this->line_end[line] = end;
+
+    int row = (y - 8 + GBA_SCREEN_HEIGHT/2) / 8;
+    if(row != this->line_row[line] || !this->line_visible[line]) {
+        if(this->line_row[line] >= 0) this->writeCells(line, false);
+        this->line_row[line] = row;
+        this->line_visible[line] = true;
+        this->writeCells(line, true);
+    }
+}
+
+void TextLayer::setVisible(int line, bool visible) {
+    if(visible == this->line_visible[line] || this->line_row[line] < 0) return;
+    this->line_visible[line] = visible;
+    this->writeCells(line, visible);
+}
+
+void TextLayer::clear(int line) {
+    if(this->line_row[line] < 0) return;
+    this->writeCells(line, false);
+    this->line_row[line] = -1;
+    this->line_visible[line] = false;
+}
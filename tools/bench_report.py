@@ -0,0 +1,206 @@
+"""
+Authors : Bugmobile & jeremyk6
+License : GPLv3
+
+Benchmark report, run by "make bench" on the benchmark ROM (see include/bench.h).
+
+The ROM is run in mGBA's headless test runner (mgba-rom-test), which prints the debug
+log of the game. The ROM keeps its measures in RAM and logs them when it exits, in frame
+order : each "BENCH <scene> <usage>" line gives the CPU usage of a frame
+(bn::core::last_cpu_usage() data, 4096 = a whole frame). The first frame of each scene
+also measures the loading of the scene and is reported apart. "BENCH check <name> ok"
+or "failed" lines give the result of the on-target checks : a failed one fails the run.
+
+For each scene the mean, 99th percentile and worst frame are printed, in percent of a
+frame. The run fails when a frame goes over the budget, when a metric is above its
+baseline (bench_baseline.json) by more than the threshold, or when the baseline or one of
+its scenes is missing : only --update-baseline runs without it.
+"""
+
+import argparse
+import json
+import re
+import subprocess
+import sys
+
+CPU_USAGE_ONE = 4096
+METRICS = ('mean', 'p99', 'worst')
+BENCH_LINE = re.compile(r'BENCH (\w+) (-?\d+)')
+CHECK_LINE = re.compile(r'BENCH check (\w+) (ok|failed)')
+
+
+def run_emulator(emulator, rom, exit_swi, timeout):
+    command = [emulator, '--exit-swi', exit_swi, '--return', 'r0', '--log-level', '127', rom]
+
+    try:
+        result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, timeout=timeout,
+                                universal_newlines=True)
+    except subprocess.TimeoutExpired:
+        raise ValueError(rom + ': no exit after ' + str(timeout) + ' seconds')
+
+    if result.returncode != 0:
+        raise ValueError(' '.join(command) + ' returned ' + str(result.returncode) + '\n' + result.stdout)
+
+    return result.stdout
+
+
+def parse_log(log):
+    scenes = {}
+    loading = {}
+    previous_scene = None
+
+    for line in log.splitlines():
+        match = BENCH_LINE.search(line)
+
+        if match:
+            scene = match.group(1)
+            usage = int(match.group(2)) * 100 / CPU_USAGE_ONE
+
+            if scene != previous_scene:
+                loading[scene] = max(loading.get(scene, 0), usage)
+            else:
+                scenes.setdefault(scene, []).append(usage)
+
+            previous_scene = scene
+
+    return scenes, loading
+
+
+def parse_checks(log):
+    checks = {}
+
+    for line in log.splitlines():
+        match = CHECK_LINE.search(line)
+
+        if match:
+            checks[match.group(1)] = checks.get(match.group(1), True) and match.group(2) == 'ok'
+
+    return checks
+
+
+def percentile(values, percent):
+    ordered = sorted(values)
+    index = min(len(ordered) - 1, int(len(ordered) * percent / 100))
+    return ordered[index]
+
+
+def scene_metrics(scenes):
+    metrics = {}
+
+    for scene, frames in scenes.items():
+        metrics[scene] = {
+            'frames': len(frames),
+            'mean': sum(frames) / len(frames),
+            'p99': percentile(frames, 99),
+            'worst': max(frames),
+        }
+
+    return metrics
+
+
+def check(metrics, loading, baseline, budget, threshold, include_loading):
+    errors = []
+
+    for scene, values in metrics.items():
+        if values['worst'] > budget:
+            errors.append(scene + ': worst frame ' + format(values['worst'], '.1f') + '% over the ' +
+                          format(budget, '.1f') + '% budget')
+
+        if scene not in baseline:
+            errors.append(scene + ': not in the baseline, run "make bench-baseline" to add it')
+        else:
+            for metric in METRICS:
+                limit = baseline[scene][metric] * (1 + threshold / 100)
+
+                if values[metric] > limit:
+                    errors.append(scene + ': ' + metric + ' ' + format(values[metric], '.1f') + '% regressed from ' +
+                                  format(baseline[scene][metric], '.1f') + '%')
+
+    if include_loading:
+        for scene, usage in loading.items():
+            if usage > budget:
+                errors.append(scene + ': loading frame ' + format(usage, '.1f') + '% over the budget')
+
+    return errors
+
+
+def print_report(metrics, loading):
+    print('scene        frames    mean     p99   worst  loading')
+
+    for scene, values in metrics.items():
+        print(format(scene, '<10') + format(values['frames'], '>9') +
+              ''.join(format(values[metric], '>7.1f') + '%' for metric in METRICS) +
+              format(loading.get(scene, 0), '>8.1f') + '%')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmark ROM report.')
+    parser.add_argument('--rom', help='benchmark ROM path')
+    parser.add_argument('--log', help='read an emulator log file instead of running the ROM')
+    parser.add_argument('--emulator', default='mgba-rom-test', help='mGBA test runner path')
+    parser.add_argument('--exit-swi', default='0x1F', help='software interrupt ending the run (BENCH_EXIT_SWI)')
+    parser.add_argument('--timeout', type=int, default=600, help='emulator timeout in seconds')
+    parser.add_argument('--baseline', default='bench_baseline.json', help='baseline metrics path')
+    parser.add_argument('--update-baseline', action='store_true', help='write the metrics as the new baseline')
+    parser.add_argument('--budget', type=float, default=100, help='CPU usage budget of a frame, in percent')
+    parser.add_argument('--threshold', type=float, default=5, help='allowed regression from the baseline, in percent')
+    parser.add_argument('--include-loading', action='store_true', help='the first frame of a scene is held to the budget too')
+    args = parser.parse_args()
+
+    try:
+        if args.log:
+            with open(args.log) as file:
+                log = file.read()
+        elif args.rom:
+            log = run_emulator(args.emulator, args.rom, args.exit_swi, args.timeout)
+        else:
+            raise ValueError('--rom or --log required')
+
+        scenes, loading = parse_log(log)
+        checks = parse_checks(log)
+
+        if not scenes:
+            raise ValueError('no BENCH line in the emulator log')
+    except (OSError, ValueError) as exception:
+        sys.stderr.write('bench error: ' + str(exception) + '\n')
+        sys.exit(-1)
+
+    metrics = scene_metrics(scenes)
+    print_report(metrics, loading)
+
+    # A failed on-target check fails the run, baseline or not
+    failed_checks = [name for name, passed in sorted(checks.items()) if not passed]
+
+    for name in failed_checks:
+        sys.stderr.write('bench error: check ' + name + ' failed\n')
+
+    if failed_checks:
+        sys.exit(1)
+
+    if args.update_baseline:
+        with open(args.baseline, 'w') as file:
+            json.dump(metrics, file, indent=4, sort_keys=True)
+            file.write('\n')
+
+        print('Baseline written to ' + args.baseline)
+        return
+
+    try:
+        with open(args.baseline) as file:
+            baseline = json.load(file)
+    except (OSError, ValueError) as exception:
+        sys.stderr.write('bench error: no baseline (' + str(exception) + '), run "make bench-baseline" on the ' +
+                         'reference build to create it\n')
+        sys.exit(-1)
+
+    errors = check(metrics, loading, baseline, args.budget, args.threshold, args.include_loading)
+
+    for error in errors:
+        sys.stderr.write('bench error: ' + error + '\n')
+
+    if errors:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
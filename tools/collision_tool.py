@@ -0,0 +1,191 @@
+"""
+Authors : Bugmobile & jeremyk6
+License : GPLv3
+
+Collision layer generator, run by the makefile EXTTOOL before graphics and code.
+
+For each collisions/<name>.json, the referenced regular bg bitmap is split in 8x8
+tiles the same way grit does (tiles reduced with flips, indexes given by order of
+appearance), and every cell is classified with the json rules. The result is a
+packed grid (one nibble of TILE_* flags per cell) written in
+<build>/collision_items_<name>.h.
+
+json format :
+{
+    "bmp": "graphics/lvl0.bmp",
+    "solid": [1, 2, 3, 4],
+    "spikes": {
+        "left": [3077],
+        "right": [5],
+        "up": [6, 10],
+        "down": [3078]
+    }
+}
+Cell values are grit map cells : tile index + 1024 for horizontal flip + 2048 for vertical flip.
+"""
+
+import argparse
+import json
+import os
+import struct
+import sys
+
+TILE_FLAG_SOLID = 0x01
+TILE_FLAG_SPIKE = 0x02
+TILE_PUSH_SHIFT = 2
+TILE_PUSH = {'left': 0, 'right': 1, 'up': 2, 'down': 3}
+
+
+def read_bmp_indexes(file_path):
+    with open(file_path, 'rb') as file:
+        data = file.read()
+
+    if data[0:2] != b'BM':
+        raise ValueError(file_path + ': not a bmp file')
+
+    pixels_offset = struct.unpack('<I', data[10:14])[0]
+    width, height = struct.unpack('<ii', data[18:26])
+    bpp = struct.unpack('<H', data[28:30])[0]
+    compression = struct.unpack('<I', data[30:34])[0]
+
+    if bpp != 8 or compression != 0:
+        raise ValueError(file_path + ': only uncompressed 8bpp bmp files are supported')
+
+    if width % 8 != 0 or abs(height) % 8 != 0:
+        raise ValueError(file_path + ': width and height must be multiple of 8')
+
+    bottom_up = height > 0
+    height = abs(height)
+    stride = (width + 3) & ~3
+    rows = []
+
+    for y in range(height):
+        row = (height - 1 - y) if bottom_up else y
+        start = pixels_offset + (row * stride)
+        rows.append(data[start:start + width])
+
+    return width, height, rows
+
+
+def grit_map_cells(width, height, rows):
+    tiles = {}
+    cells = []
+
+    for cell_y in range(height // 8):
+        for cell_x in range(width // 8):
+            tile = tuple(bytes(rows[(cell_y * 8) + y][cell_x * 8:(cell_x * 8) + 8]) for y in range(8))
+            horizontal_flip = tuple(row[::-1] for row in tile)
+            candidates = (tile, horizontal_flip, tile[::-1], horizontal_flip[::-1])
+            cell = None
+
+            for flips, candidate in enumerate(candidates):
+                tile_index = tiles.get(candidate)
+
+                if tile_index is not None:
+                    cell = tile_index | (flips << 10)
+                    break
+
+            if cell is None:
+                cell = len(tiles)
+                tiles[tile] = cell
+
+            cells.append(cell)
+
+    return cells
+
+
+def cell_flags_table(rules):
+    table = {}
+
+    for cell in rules.get('solid', []):
+        table[cell] = TILE_FLAG_SOLID
+
+    for direction, cells in rules.get('spikes', {}).items():
+        if direction not in TILE_PUSH:
+            raise ValueError('Invalid spikes direction: ' + direction)
+
+        for cell in cells:
+            table[cell] = TILE_FLAG_SPIKE | (TILE_PUSH[direction] << TILE_PUSH_SHIFT)
+
+    return table
+
+
+def write_header(name, columns, rows, flags, file_path):
+    packed = []
+
+    for index in range(0, len(flags), 2):
+        packed.append(flags[index] | (flags[index + 1] << 4))
+
+    lines = []
+
+    for index in range(0, len(packed), 32):
+        lines.append('        ' + ', '.join('0x%02x' % value for value in packed[index:index + 32]) + ',')
+
+    guard = 'COLLISION_ITEMS_' + name.upper() + '_H'
+
+    with open(file_path, 'w') as file:
+        file.write('#ifndef ' + guard + '\n')
+        file.write('#define ' + guard + '\n\n')
+        file.write('#include "collision_grid.h"\n\n')
+        file.write('namespace collision_items\n')
+        file.write('{\n')
+        file.write('    constexpr inline unsigned char ' + name + '_cells[] = {\n')
+        file.write('\n'.join(lines) + '\n')
+        file.write('    };\n\n')
+        file.write('    constexpr inline CollisionGrid ' + name + '(' + name + '_cells, ' + str(columns) + ', ' +
+                   str(rows) + ');\n')
+        file.write('}\n\n')
+        file.write('#endif\n')
+
+
+def process(json_path, build_folder):
+    name = os.path.splitext(os.path.basename(json_path))[0]
+    header_path = os.path.join(build_folder, 'collision_items_' + name + '.h')
+
+    with open(json_path) as file:
+        rules = json.load(file)
+
+    bmp_path = rules['bmp']
+
+    if os.path.isfile(header_path):
+        header_time = os.path.getmtime(header_path)
+
+        if header_time >= os.path.getmtime(json_path) and header_time >= os.path.getmtime(bmp_path) and \
+                header_time >= os.path.getmtime(__file__):
+            return False
+
+    width, height, rows = read_bmp_indexes(bmp_path)
+    columns = width // 8
+    cells = grit_map_cells(width, height, rows)
+    table = cell_flags_table(rules)
+    flags = [table.get(cell, 0) for cell in cells]
+
+    if columns % 2 != 0:
+        raise ValueError(bmp_path + ': width must be multiple of 16')
+
+    write_header(name, columns, height // 8, flags, header_path)
+    return True
+
+
+def process_all(collisions_folder, build_folder):
+    if not os.path.isdir(build_folder):
+        os.makedirs(build_folder, exist_ok=True)
+
+    for file_name in sorted(os.listdir(collisions_folder)):
+        if file_name.endswith('.json'):
+            json_path = os.path.join(collisions_folder, file_name)
+
+            try:
+                if process(json_path, build_folder):
+                    print(file_name)
+            except Exception as exception:
+                sys.stderr.write(json_path + ' error: ' + str(exception) + '\n')
+                sys.exit(-1)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser(description='Collision layer generator.')
+    parser.add_argument('--collisions', default='collisions', help='collision rules folder path')
+    parser.add_argument('--build', required=True, help='build folder path')
+    args = parser.parse_args()
+    process_all(args.collisions, args.build)
@@ -0,0 +1,175 @@
+"""
+Authors : Bugmobile & jeremyk6
+License : GPLv3
+
+Link map report, run by "make release-perf" and "make map-report".
+
+Reads the GNU ld map file of the ROM and sums the size of the input sections of each
+object file by memory region, from their run address : IWRAM (0x03000000, 32 KiB),
+EWRAM (0x02000000, 256 KiB) and ROM (0x08000000). Code and data copied to IWRAM or
+EWRAM at boot are counted in their run region only.
+
+Objects built from src/ are reported by module (collision.bn_iwram.o : collision),
+the others (butano, assets, libraries) are summed in "other" unless --all is given.
+With -flto, the modules are merged in the link-time partitions (*.ltrans.o) : the
+module report is only given by a build without LTO (make map-report).
+
+The run fails when the src/ modules use more IWRAM than --iwram-budget bytes.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+REGIONS = (
+    ('iwram', 0x03000000, 0x03008000),
+    ('ewram', 0x02000000, 0x02040000),
+    ('rom', 0x08000000, 0x0A000000),
+)
+REGION_SIZES = {'iwram': 0x8000, 'ewram': 0x40000, 'rom': 0x2000000}
+MAP_START = 'Linker script and memory map'
+SECTION_LINE = re.compile(r'^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+SECTION_NAME_LINE = re.compile(r'^ (\S+)$')
+SECTION_VALUES_LINE = re.compile(r'^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+
+
+def region_of(address):
+    for name, start, end in REGIONS:
+        if start <= address < end:
+            return name
+
+    return None
+
+
+def object_module(object_path, modules, all_objects):
+    object_path = object_path.strip()
+
+    if '.ltrans' in object_path:
+        return 'lto'
+
+    # Archive member : libname.a(member.o)
+    archive = re.match(r'(.*)\((.*)\)$', object_path)
+    file_name = os.path.basename(archive.group(2) if archive else object_path)
+    stem = file_name.split('.')[0]
+
+    if stem in modules:
+        return stem
+
+    if all_objects:
+        return os.path.basename(archive.group(1)) + ':' + stem if archive else stem
+
+    return 'other'
+
+
+def parse_map(map_text, modules, all_objects):
+    usage = {}
+    started = False
+    pending_section = None
+
+    for line in map_text.splitlines():
+        if not started:
+            started = line.startswith(MAP_START)
+            continue
+
+        match = SECTION_LINE.match(line)
+
+        if match:
+            section, address, size, object_path = match.groups()
+        elif pending_section:
+            match = SECTION_VALUES_LINE.match(line)
+            section = pending_section
+            pending_section = None
+
+            if not match:
+                continue
+
+            address, size, object_path = match.groups()
+        else:
+            match = SECTION_NAME_LINE.match(line)
+
+            if match and not match.group(1).startswith('*'):
+                pending_section = match.group(1)
+
+            continue
+
+        pending_section = None
+
+        if section.startswith('*') or section.startswith('.debug'):
+            continue
+
+        region = region_of(int(address, 16))
+        size = int(size, 16)
+
+        if region is None or size == 0:
+            continue
+
+        module = object_module(object_path, modules, all_objects)
+        usage.setdefault(module, {name: 0 for name, start, end in REGIONS})[region] += size
+
+    return usage
+
+
+def source_modules(sources):
+    modules = set()
+
+    for file_name in os.listdir(sources):
+        if file_name.endswith('.cpp'):
+            modules.add(file_name.split('.')[0])
+
+    return modules
+
+
+def print_report(usage, modules):
+    print(format('module', '<24') + ''.join(format(name, '>10') for name, start, end in REGIONS))
+    totals = {name: 0 for name, start, end in REGIONS}
+
+    def ordered(module):
+        return (module not in modules, -usage[module]['iwram'], module)
+
+    for module in sorted(usage, key=ordered):
+        values = usage[module]
+        print(format(module, '<24') + ''.join(format(values[name], '>10') for name, start, end in REGIONS))
+
+        for name in totals:
+            totals[name] += values[name]
+
+    print(format('total', '<24') + ''.join(format(totals[name], '>10') for name, start, end in REGIONS))
+    print(format('used', '<24') + ''.join(format(totals[name] * 100 / REGION_SIZES[name], '>9.1f') + '%'
+                                          for name, start, end in REGIONS))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Link map report.')
+    parser.add_argument('--map', required=True, help='ld map file path')
+    parser.add_argument('--sources', default='src', help='source folder, its files are reported by module')
+    parser.add_argument('--all', action='store_true', help='report every object file')
+    parser.add_argument('--iwram-budget', type=int, default=0, help='IWRAM bytes allowed to the src/ modules (0 : no limit)')
+    args = parser.parse_args()
+
+    try:
+        with open(args.map) as file:
+            map_text = file.read()
+
+        modules = source_modules(args.sources)
+        usage = parse_map(map_text, modules, args.all)
+
+        if not usage:
+            raise ValueError(args.map + ': no input section found')
+    except (OSError, ValueError) as exception:
+        sys.stderr.write('map report error: ' + str(exception) + '\n')
+        sys.exit(-1)
+
+    print_report(usage, modules)
+
+    if args.iwram_budget:
+        iwram = sum(values['iwram'] for module, values in usage.items() if module in modules)
+
+        if iwram > args.iwram_budget:
+            sys.stderr.write('map report error: src/ modules use ' + str(iwram) + ' IWRAM bytes, budget ' +
+                             str(args.iwram_budget) + '\n')
+            sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()